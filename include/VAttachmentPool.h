@@ -0,0 +1,240 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include <SDL.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VErrors.h"
+#include "VMemory.h"
+#include "VImages.h"
+#include "VMemoryBudget.h"
+
+namespace Vigor
+{
+	/*
+	* An attachment image bound to pool owned memory
+	*/
+	struct PooledAttachment
+	{
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView imageView = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		uint32_t blockIndex = UINT32_MAX;
+	};
+
+	/*
+	* Engine wide backing memory for render targets, kept across swapchain recreation.
+	*
+	* Images are cheap to recreate, memory is not, so a resize only makes new images and binds them to blocks the pool
+	*	already holds. Blocks are sized in buckets (eighths of a power of two) so a window edge being dragged keeps fitting
+	*	the same one. Attachments in the same alias group share a block: every window's pass clears its attachments on load
+	*	and discards them on store, and passes on the one graphics queue are ordered by their external subpass dependency,
+	*	the same guarantee that lets frames in flight share one attachment. Blocks left unused are freed after a while,
+	*	or straight away under memory pressure.
+	*/
+	class AttachmentPool
+	{
+	public:
+		static constexpr uint32_t NoAliasing = 0;
+		static constexpr uint32_t IdleFramesBeforeFree = 240; // a few seconds, longer than any resize drag pauses
+
+		AttachmentPool()
+			: frameNumber(0)
+		{
+
+		}
+
+		/*
+		* Image and view for a width x height attachment, bound to a block of at least the image's size. aliasGroup other
+		*	than NoAliasing shares memory with other attachments of that group, whose use must never overlap on the GPU
+		*/
+		PooledAttachment Acquire
+		(
+			VkDevice vkDevice,
+			VkPhysicalDevice vkPhysicalDevice,
+			uint32_t width,
+			uint32_t height,
+			VkSampleCountFlagBits numSamples,
+			VkFormat format,
+			VkImageUsageFlags usage,
+			VkImageAspectFlags aspectFlags,
+			uint32_t aliasGroup
+		)
+		{
+			PooledAttachment attachment{};
+			attachment.format = format;
+			Images::CreateUnboundImage(vkDevice, width, height, 1, numSamples, format, VK_IMAGE_TILING_OPTIMAL, usage, attachment.image);
+
+			VkMemoryRequirements memoryRequirements;
+			vkGetImageMemoryRequirements(vkDevice, attachment.image, &memoryRequirements);
+
+			uint32_t memoryTypeIndex = Memory::FindMemoryType(vkPhysicalDevice, memoryRequirements.memoryTypeBits, MemoryUsage::TransientAttachment, memoryRequirements.size);
+
+			attachment.blockIndex = FindBlock(memoryRequirements.size, memoryTypeIndex, aliasGroup);
+			if (attachment.blockIndex == UINT32_MAX)
+			{
+				attachment.blockIndex = AllocateBlock(vkDevice, memoryRequirements, memoryTypeIndex, aliasGroup);
+			}
+
+			Block& block = blocks[attachment.blockIndex];
+			block.users++;
+			block.aliasGroup = aliasGroup;
+
+			attachment.memory = block.memory;
+			vkBindImageMemory(vkDevice, attachment.image, block.memory, 0);
+
+			attachment.imageView = Images::CreateImageView(vkDevice, attachment.image, format, aspectFlags, 1);
+
+			return attachment;
+		}
+
+		/*
+		* !! NOTE !! the GPU must be done with the attachment, its block may be handed straight back out
+		*/
+		void Release(VkDevice vkDevice, PooledAttachment& attachment)
+		{
+			if (attachment.blockIndex == UINT32_MAX)
+			{
+				return;
+			}
+
+			vkDestroyImageView(vkDevice, attachment.imageView, nullptr);
+			vkDestroyImage(vkDevice, attachment.image, nullptr);
+
+			Block& block = blocks[attachment.blockIndex];
+			if (--block.users == 0)
+			{
+				block.lastUsedFrame = frameNumber;
+			}
+
+			attachment = PooledAttachment{};
+		}
+
+		/*
+		* Once a frame, frees blocks nobody has wanted for IdleFramesBeforeFree frames, or every unused one when over budget
+		*/
+		void Trim(VkDevice vkDevice)
+		{
+			frameNumber++;
+
+			uint32_t deviceLocalHeap = Memory::Budget().GetDeviceLocalHeap();
+			bool bOverBudget = !Memory::Budget().Fits(deviceLocalHeap, 0, 0, MemoryBudget::HighWaterFraction);
+
+			for (Block& block : blocks)
+			{
+				if (block.memory != VK_NULL_HANDLE && block.users == 0 && (bOverBudget || frameNumber - block.lastUsedFrame > IdleFramesBeforeFree))
+				{
+					Memory::FreeMemory(vkDevice, block.memory);
+					block = Block{};
+				}
+			}
+		}
+
+		void Shutdown(VkDevice vkDevice)
+		{
+			for (Block& block : blocks)
+			{
+				Memory::FreeMemory(vkDevice, block.memory);
+			}
+
+			blocks.clear();
+		}
+
+	private:
+		/*
+		* A live block of the same alias group first, so windows share, then the smallest free block that is not wastefully large
+		*/
+		uint32_t FindBlock(VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t aliasGroup) const
+		{
+			uint32_t bestIndex = UINT32_MAX;
+			for (uint32_t i = 0; i < static_cast<uint32_t>(blocks.size()); i++)
+			{
+				const Block& block = blocks[i];
+				if (block.memory == VK_NULL_HANDLE || block.memoryTypeIndex != memoryTypeIndex || block.size < size)
+				{
+					continue;
+				}
+
+				if (block.users > 0)
+				{
+					if (aliasGroup != NoAliasing && block.aliasGroup == aliasGroup)
+					{
+						return i;
+					}
+
+					continue;
+				}
+
+				if (block.size <= BucketSize(size) * 2 && (bestIndex == UINT32_MAX || block.size < blocks[bestIndex].size))
+				{
+					bestIndex = i;
+				}
+			}
+
+			return bestIndex;
+		}
+
+		uint32_t AllocateBlock(VkDevice vkDevice, VkMemoryRequirements memoryRequirements, uint32_t memoryTypeIndex, uint32_t aliasGroup)
+		{
+			Block block{};
+			block.size = BucketSize(memoryRequirements.size);
+			block.memoryTypeIndex = memoryTypeIndex;
+			block.aliasGroup = aliasGroup;
+
+			memoryRequirements.size = block.size;
+			VkResult allocateMemoryRes = Memory::AllocateMemory(vkDevice, memoryRequirements, memoryTypeIndex, MemoryCategory::Attachment, block.memory);
+			if (allocateMemoryRes != VK_SUCCESS)
+			{
+				Vigor::Errors::RaiseRuntimeError("Failed to allocate attachment memory Error: {}\n\n", (int)allocateMemoryRes);
+			}
+
+			for (uint32_t i = 0; i < static_cast<uint32_t>(blocks.size()); i++)
+			{
+				if (blocks[i].memory == VK_NULL_HANDLE)
+				{
+					blocks[i] = block;
+					return i;
+				}
+			}
+
+			blocks.push_back(block);
+			return static_cast<uint32_t>(blocks.size() - 1);
+		}
+
+		/*
+		* Round up to an eighth of the next power of two, at most 25% slack
+		*/
+		static VkDeviceSize BucketSize(VkDeviceSize size)
+		{
+			VkDeviceSize powerOfTwo = 1;
+			while (powerOfTwo < size)
+			{
+				powerOfTwo <<= 1;
+			}
+
+			VkDeviceSize step = std::max<VkDeviceSize>(powerOfTwo / 8, 1);
+			return (size + step - 1) / step * step;
+		}
+
+	private:
+		struct Block
+		{
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkDeviceSize size = 0;
+			uint32_t memoryTypeIndex = 0;
+			uint32_t aliasGroup = NoAliasing;
+			uint32_t users = 0;
+			uint64_t lastUsedFrame = 0;
+		};
+
+		uint64_t frameNumber;
+		std::vector<Block> blocks;
+	};
+}
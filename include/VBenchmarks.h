@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VWindow.h"
+#include "VMemory.h"
+#include "VDescriptors.h"
+#include "VEngineTypes.h"
+
+namespace Vigor
+{
+	namespace Benchmarks
+	{
+		/*
+		* Measure per draw uniform buffer binding changes recorded through a descriptor backend.
+		*	Nothing is submitted, this only covers the CPU/driver cost of updating and binding descriptors.
+		*/
+		static double DescriptorUpdatesPerMillisecond(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, const QueueFamilyIndicies& queueFamilyIndicies, DescriptorBackend& descriptorBackend, uint32_t drawCount)
+		{
+			constexpr uint32_t uniformSlotCount = 16;
+
+			VkPhysicalDeviceProperties physicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(vkPhysicalDevice, &physicalDeviceProperties);
+
+			VkDeviceSize alignment = physicalDeviceProperties.limits.minUniformBufferOffsetAlignment;
+			VkDeviceSize uniformSlotSize = (sizeof(ModelViewProjectionBuffer) + alignment - 1) & ~(alignment - 1);
+
+			// Same set 0 layout the windows use
+			descriptorBackend.InitSetLayout(vkDevice, Descriptors::GetFrameSetBindings());
+			descriptorBackend.InitPool(vkDevice, 1);
+
+			VkDescriptorSetLayout setLayout = descriptorBackend.GetSetLayout();
+
+			VkPipelineLayoutCreateInfo createInfoPipelineLayout{};
+			createInfoPipelineLayout.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			createInfoPipelineLayout.setLayoutCount = 1;
+			createInfoPipelineLayout.pSetLayouts = &setLayout;
+
+			VkPipelineLayout pipelineLayout;
+			if (vkCreatePipelineLayout(vkDevice, &createInfoPipelineLayout, nullptr, &pipelineLayout) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to create benchmark pipeline layout!");
+			}
+
+			VkBuffer uniformBuffer;
+			VkDeviceMemory uniformBufferMemory;
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				uniformSlotSize * uniformSlotCount,
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | descriptorBackend.GetRequiredBufferUsage(),
+				MemoryUsage::Dynamic,
+				uniformBuffer,
+				uniformBufferMemory,
+				MemoryCategory::Uniform,
+				descriptorBackend.GetRequiredAllocateFlags()
+			);
+
+			VkCommandPoolCreateInfo createInfoCommandPool{};
+			createInfoCommandPool.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			createInfoCommandPool.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			createInfoCommandPool.queueFamilyIndex = queueFamilyIndicies.graphicsFamily.value();
+
+			VkCommandPool commandPool;
+			if (vkCreateCommandPool(vkDevice, &createInfoCommandPool, nullptr, &commandPool) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to create benchmark command pool!");
+			}
+
+			VkCommandBufferAllocateInfo allocInfoCommandBuffer{};
+			allocInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfoCommandBuffer.commandPool = commandPool;
+			allocInfoCommandBuffer.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfoCommandBuffer.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			if (vkAllocateCommandBuffers(vkDevice, &allocInfoCommandBuffer, &commandBuffer) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to allocate benchmark command buffer!");
+			}
+
+			VkCommandBufferBeginInfo beginInfoCommandBuffer{};
+			beginInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfoCommandBuffer.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			// record in batches so the pooled backend's transient pool never runs dry
+			uint32_t drawsRecorded = 0;
+			while (drawsRecorded < drawCount)
+			{
+				uint32_t batchSize = std::min(MAX_TRANSIENT_DESCRIPTOR_SETS, drawCount - drawsRecorded);
+
+				vkBeginCommandBuffer(commandBuffer, &beginInfoCommandBuffer);
+				for (uint32_t i = 0; i < batchSize; i++)
+				{
+					VkDescriptorBufferInfo bufferInfo{};
+					bufferInfo.buffer = uniformBuffer;
+					bufferInfo.offset = uniformSlotSize * ((drawsRecorded + i) % uniformSlotCount);
+					bufferInfo.range = sizeof(ModelViewProjectionBuffer);
+
+					descriptorBackend.BindTransient(vkDevice, commandBuffer, pipelineLayout, 0, 0, 0, bufferInfo);
+				}
+				vkEndCommandBuffer(commandBuffer);
+
+				vkResetCommandBuffer(commandBuffer, 0);
+				descriptorBackend.ResetTransient(vkDevice, 0);
+
+				drawsRecorded += batchSize;
+			}
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+			// Cleanup
+			vkDestroyCommandPool(vkDevice, commandPool, nullptr);
+			vkDestroyBuffer(vkDevice, uniformBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, uniformBufferMemory);
+			vkDestroyPipelineLayout(vkDevice, pipelineLayout, nullptr);
+			descriptorBackend.Shutdown(vkDevice);
+
+			return elapsedMs > 0.0 ? drawCount / elapsedMs : 0.0;
+		}
+	}
+}
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VErrors.h"
+#include "VMemory.h"
+
+namespace Vigor
+{
+	constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
+
+	/*
+	* Global texture array backed by Vulkan 1.2 descriptor indexing.
+	*
+	* Textures register into a slot of a single update-after-bind descriptor set (set 1, binding 0)
+	*	and the fragment shader indexes that array with a per-draw material index, so texture changes
+	*	no longer require a different descriptor set per draw.
+	*
+	* When the engine runs the descriptor buffer backend the same array is written with vkGetDescriptorEXT
+	*	into a host visible descriptor buffer instead, as pipelines using descriptor buffers cannot mix in sets.
+	*/
+	class BindlessTextureTable
+	{
+	public:
+		BindlessTextureTable()
+			: capacity(0)
+			, nextSlot(0)
+			, descriptorSetLayout(VK_NULL_HANDLE)
+			, descriptorPool(VK_NULL_HANDLE)
+			, descriptorSet(VK_NULL_HANDLE)
+			, bUseDescriptorBuffer(false)
+			, descriptorBuffer(VK_NULL_HANDLE)
+			, descriptorBufferMemory(VK_NULL_HANDLE)
+			, descriptorBufferMapped(nullptr)
+			, descriptorBufferAddress(0)
+			, bindingOffset(0)
+			, combinedImageSamplerDescriptorSize(0)
+		{
+
+		}
+
+		/*
+		* Query the device features needed by the table, returns false if any are missing
+		*/
+		static bool IsSupported(VkPhysicalDevice vkPhysicalDevice)
+		{
+			VkPhysicalDeviceVulkan12Features vulkan12Features{};
+			vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+			VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
+			physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			physicalDeviceFeatures2.pNext = &vulkan12Features;
+
+			vkGetPhysicalDeviceFeatures2(vkPhysicalDevice, &physicalDeviceFeatures2);
+
+			return
+				vulkan12Features.descriptorIndexing == VK_TRUE &&
+				vulkan12Features.runtimeDescriptorArray == VK_TRUE &&
+				vulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+				vulkan12Features.descriptorBindingVariableDescriptorCount == VK_TRUE &&
+				vulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+				vulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+				vulkan12Features.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+		}
+
+		/*
+		* Fill in the descriptor indexing features the table relies on, chain into VkDeviceCreateInfo::pNext
+		*/
+		static void EnableRequiredFeatures(VkPhysicalDeviceVulkan12Features& vulkan12Features)
+		{
+			vulkan12Features.descriptorIndexing = VK_TRUE;
+			vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+			vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+			vulkan12Features.descriptorBindingVariableDescriptorCount = VK_TRUE;
+			vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		}
+
+		/*
+		* Initialize layout, update-after-bind pool and the single global set,
+		*	or the layout and descriptor buffer when _bUseDescriptorBuffer is set
+		*/
+		void Init(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, bool _bUseDescriptorBuffer = false)
+		{
+			bUseDescriptorBuffer = _bUseDescriptorBuffer;
+
+			// Clamp the array size to what the device allows for update-after-bind sampled images
+			VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+			vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+			VkPhysicalDeviceProperties2 physicalDeviceProperties2{};
+			physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			physicalDeviceProperties2.pNext = &vulkan12Properties;
+
+			vkGetPhysicalDeviceProperties2(vkPhysicalDevice, &physicalDeviceProperties2);
+
+			capacity = std::min
+			({
+				MAX_BINDLESS_TEXTURES,
+				vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+				vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+				vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+				vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers
+			});
+
+			InitDescriptorSetLayout(vkDevice);
+
+			if (bUseDescriptorBuffer)
+			{
+				InitDescriptorBuffer(vkDevice, vkPhysicalDevice);
+				return;
+			}
+
+			InitDescriptorPool(vkDevice);
+			InitDescriptorSet(vkDevice);
+		}
+
+		/*
+		* Register a texture into a free slot, returns the slot index used as the shader material index
+		*/
+		uint32_t RegisterTexture(VkDevice vkDevice, VkImageView imageView, VkSampler sampler)
+		{
+			uint32_t slot = 0;
+			if (!freeSlots.empty())
+			{
+				slot = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else if (nextSlot < capacity)
+			{
+				slot = nextSlot++;
+			}
+			else
+			{
+				Vigor::Errors::RaiseRuntimeError("Bindless texture table is full, capacity: {}\n\n", capacity);
+			}
+
+			UpdateTexture(vkDevice, slot, imageView, sampler);
+
+			return slot;
+		}
+
+		/*
+		* Overwrite an already registered slot, valid while the set is bound thanks to update-after-bind
+		*	!! NOTE !! only for slots no submitted frame still reads, re-register into a fresh slot otherwise
+		*/
+		void UpdateTexture(VkDevice vkDevice, uint32_t slot, VkImageView imageView, VkSampler sampler)
+		{
+			VkDescriptorImageInfo imageInfo{};
+			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			imageInfo.imageView = imageView;
+			imageInfo.sampler = sampler;
+
+			if (bUseDescriptorBuffer)
+			{
+				VkDescriptorGetInfoEXT descriptorGetInfo{};
+				descriptorGetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+				descriptorGetInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				descriptorGetInfo.data.pCombinedImageSampler = &imageInfo;
+
+				// array elements are tightly packed from the binding offset
+				uint8_t* slotDescriptor = static_cast<uint8_t*>(descriptorBufferMapped) + bindingOffset + slot * combinedImageSamplerDescriptorSize;
+				vkGetDescriptorEXT(vkDevice, &descriptorGetInfo, combinedImageSamplerDescriptorSize, slotDescriptor);
+				return;
+			}
+
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = descriptorSet;
+			descriptorWrite.dstBinding = 0;
+			descriptorWrite.dstArrayElement = slot;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pImageInfo = &imageInfo;
+
+			vkUpdateDescriptorSets(vkDevice, 1, &descriptorWrite, 0, nullptr);
+		}
+
+		/*
+		* Return a slot to the free list
+		*	!! NOTE !! the caller must make sure no in-flight frame still samples from the slot
+		*/
+		void UnregisterTexture(uint32_t slot)
+		{
+			freeSlots.push_back(slot);
+		}
+
+		VkDescriptorSetLayout GetSetLayout() const
+		{
+			return descriptorSetLayout;
+		}
+
+		VkDescriptorSet GetDescriptorSet() const
+		{
+			return descriptorSet;
+		}
+
+		uint32_t GetCapacity() const
+		{
+			return capacity;
+		}
+
+		bool UsesDescriptorBuffer() const
+		{
+			return bUseDescriptorBuffer;
+		}
+
+		/*
+		* Binding info for vkCmdBindDescriptorBuffersEXT, descriptor buffer mode only
+		*/
+		VkDescriptorBufferBindingInfoEXT GetDescriptorBufferBindingInfo() const
+		{
+			VkDescriptorBufferBindingInfoEXT bindingInfo{};
+			bindingInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+			bindingInfo.address = descriptorBufferAddress;
+			bindingInfo.usage = DESCRIPTOR_BUFFER_USAGE;
+
+			return bindingInfo;
+		}
+
+		void Shutdown(VkDevice vkDevice)
+		{
+			if (bUseDescriptorBuffer)
+			{
+				vkUnmapMemory(vkDevice, descriptorBufferMemory);
+				vkDestroyBuffer(vkDevice, descriptorBuffer, nullptr);
+				Memory::FreeMemory(vkDevice, descriptorBufferMemory);
+			}
+			else
+			{
+				vkDestroyDescriptorPool(vkDevice, descriptorPool, nullptr);
+			}
+
+			vkDestroyDescriptorSetLayout(vkDevice, descriptorSetLayout, nullptr);
+		}
+
+	private:
+		void InitDescriptorSetLayout(VkDevice vkDevice)
+		{
+			VkDescriptorSetLayoutBinding texturesLayoutBinding{};
+			texturesLayoutBinding.binding = 0;
+			texturesLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			texturesLayoutBinding.descriptorCount = capacity;
+			texturesLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			texturesLayoutBinding.pImmutableSamplers = nullptr;
+
+			/*
+			* UPDATE_AFTER_BIND - slots can be written while the set is bound in a command buffer being recorded
+			* UPDATE_UNUSED_WHILE_PENDING - slots no queued frame reads can be written while those frames execute
+			* PARTIALLY_BOUND - unused slots may hold no valid descriptor
+			* VARIABLE_DESCRIPTOR_COUNT - the actual array size is chosen at allocation time
+			*
+			* Descriptor buffers are plain memory so only PARTIALLY_BOUND applies to them
+			*/
+			VkDescriptorBindingFlags bindingFlags = bUseDescriptorBuffer
+				? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+				: VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+
+			VkDescriptorSetLayoutBindingFlagsCreateInfo createInfoBindingFlags{};
+			createInfoBindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+			createInfoBindingFlags.bindingCount = 1;
+			createInfoBindingFlags.pBindingFlags = &bindingFlags;
+
+			VkDescriptorSetLayoutCreateInfo createInfoDescriptorSetLayout{};
+			createInfoDescriptorSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			createInfoDescriptorSetLayout.pNext = &createInfoBindingFlags;
+			createInfoDescriptorSetLayout.flags = bUseDescriptorBuffer ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+			createInfoDescriptorSetLayout.bindingCount = 1;
+			createInfoDescriptorSetLayout.pBindings = &texturesLayoutBinding;
+
+			if (vkCreateDescriptorSetLayout(vkDevice, &createInfoDescriptorSetLayout, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create bindless texture descriptor set layout!");
+			}
+		}
+
+		void InitDescriptorPool(VkDevice vkDevice)
+		{
+			VkDescriptorPoolSize poolSize{};
+			poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			poolSize.descriptorCount = capacity;
+
+			VkDescriptorPoolCreateInfo createInfoDescriptorPool{};
+			createInfoDescriptorPool.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			createInfoDescriptorPool.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+			createInfoDescriptorPool.poolSizeCount = 1;
+			createInfoDescriptorPool.pPoolSizes = &poolSize;
+			createInfoDescriptorPool.maxSets = 1;
+
+			if (vkCreateDescriptorPool(vkDevice, &createInfoDescriptorPool, nullptr, &descriptorPool) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create bindless texture descriptor pool!");
+			}
+		}
+
+		void InitDescriptorSet(VkDevice vkDevice)
+		{
+			VkDescriptorSetVariableDescriptorCountAllocateInfo allocInfoVariableCount{};
+			allocInfoVariableCount.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+			allocInfoVariableCount.descriptorSetCount = 1;
+			allocInfoVariableCount.pDescriptorCounts = &capacity;
+
+			VkDescriptorSetAllocateInfo allocInfoDescriptorSet{};
+			allocInfoDescriptorSet.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocInfoDescriptorSet.pNext = &allocInfoVariableCount;
+			allocInfoDescriptorSet.descriptorPool = descriptorPool;
+			allocInfoDescriptorSet.descriptorSetCount = 1;
+			allocInfoDescriptorSet.pSetLayouts = &descriptorSetLayout;
+
+			if (vkAllocateDescriptorSets(vkDevice, &allocInfoDescriptorSet, &descriptorSet) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to allocate bindless texture descriptor set!");
+			}
+		}
+
+		void InitDescriptorBuffer(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
+		{
+			vkGetDescriptorSetLayoutSizeEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetDescriptorSetLayoutSizeEXT"));
+			vkGetDescriptorSetLayoutBindingOffsetEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
+			vkGetDescriptorEXT = reinterpret_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetDescriptorEXT"));
+			if (vkGetDescriptorSetLayoutSizeEXT == nullptr || vkGetDescriptorSetLayoutBindingOffsetEXT == nullptr || vkGetDescriptorEXT == nullptr)
+			{
+				throw std::runtime_error("Failed to load descriptor buffer functions for the bindless texture table!");
+			}
+
+			VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties{};
+			descriptorBufferProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+
+			VkPhysicalDeviceProperties2 physicalDeviceProperties2{};
+			physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			physicalDeviceProperties2.pNext = &descriptorBufferProperties;
+
+			vkGetPhysicalDeviceProperties2(vkPhysicalDevice, &physicalDeviceProperties2);
+
+			combinedImageSamplerDescriptorSize = descriptorBufferProperties.combinedImageSamplerDescriptorSize;
+
+			VkDeviceSize layoutSize = 0;
+			vkGetDescriptorSetLayoutSizeEXT(vkDevice, descriptorSetLayout, &layoutSize);
+			vkGetDescriptorSetLayoutBindingOffsetEXT(vkDevice, descriptorSetLayout, 0, &bindingOffset);
+
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				layoutSize,
+				DESCRIPTOR_BUFFER_USAGE | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+				MemoryUsage::Dynamic,
+				descriptorBuffer,
+				descriptorBufferMemory,
+				MemoryCategory::Descriptor,
+				VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+			);
+
+			vkMapMemory(vkDevice, descriptorBufferMemory, 0, layoutSize, 0, &descriptorBufferMapped);
+
+			VkBufferDeviceAddressInfo bufferDeviceAddressInfo{};
+			bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+			bufferDeviceAddressInfo.buffer = descriptorBuffer;
+			descriptorBufferAddress = vkGetBufferDeviceAddress(vkDevice, &bufferDeviceAddressInfo);
+		}
+
+	private:
+		// combined image samplers need both the sampler and resource usage
+		static constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+		uint32_t capacity;
+		uint32_t nextSlot;
+		std::vector<uint32_t> freeSlots;
+
+		VkDescriptorSetLayout descriptorSetLayout;
+		VkDescriptorPool descriptorPool;
+		VkDescriptorSet descriptorSet;
+
+		// Descriptor buffer mode
+		bool bUseDescriptorBuffer;
+		VkBuffer descriptorBuffer;
+		VkDeviceMemory descriptorBufferMemory;
+		void* descriptorBufferMapped;
+		VkDeviceAddress descriptorBufferAddress;
+		VkDeviceSize bindingOffset;
+		size_t combinedImageSamplerDescriptorSize;
+
+		PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT = nullptr;
+		PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT = nullptr;
+		PFN_vkGetDescriptorEXT vkGetDescriptorEXT = nullptr;
+	};
+}
@@ -3,4 +3,7 @@
 #define VULKAN_VALIDATION_LAYERS_ENABLED 1
 #define VULKAN_VALIDATION_LAYER_VERBOSE_LOGGING 1
 
+// Compile shaders/glsl at startup with shaderc (Vulkan SDK) instead of using the embedded SPIR-V, for shader iteration
+#define VIGOR_RUNTIME_SHADER_COMPILATION 0
+
 #define KHRONOS_VALIDATION_LAYER_NAME "VK_LAYER_KHRONOS_validation"
\ No newline at end of file
@@ -0,0 +1,711 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VErrors.h"
+#include "VMemory.h"
+#include "VEngineTypes.h"
+#include "VBindlessTextures.h"
+
+namespace Vigor
+{
+	constexpr uint32_t MAX_TRANSIENT_DESCRIPTOR_SETS = 1024; // per frame, pooled and descriptor buffer backends
+
+	/*
+	* Common interface for the ways a window can feed its per frame/per draw bindings (set 0) to the GPU
+	*/
+	class DescriptorBackend
+	{
+	public:
+		virtual ~DescriptorBackend() = default;
+
+		virtual const char* GetName() const = 0;
+
+		/*
+		* Create the set layout for the given bindings
+		*/
+		virtual void InitSetLayout(VkDevice vkDevice, const std::vector<VkDescriptorSetLayoutBinding>& bindings) = 0;
+
+		/*
+		* Create any per frame storage needed to hold frameCount persistent sets
+		*/
+		virtual void InitPool(VkDevice vkDevice, uint32_t frameCount) = 0;
+
+		/*
+		* Point a uniform buffer binding of a frame's persistent set at bufferInfo
+		*/
+		virtual void WriteUniformBuffer(VkDevice vkDevice, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) = 0;
+
+		/*
+		* Bind the frame's persistent set at set 0 and the engine's texture table at set 1
+		*/
+		virtual void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t frameIdx, const BindlessTextureTable& textureTable) = 0;
+
+		/*
+		* Bind a one-off set for a single draw where only binding changes
+		*/
+		virtual void BindTransient(VkDevice vkDevice, VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t setIdx, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) = 0;
+
+		/*
+		* Release transient sets handed out for frameIdx, call once that frame's fence has signalled
+		*/
+		virtual void ResetTransient(VkDevice vkDevice, uint32_t frameIdx) = 0;
+
+		virtual void Shutdown(VkDevice vkDevice) = 0;
+
+		/*
+		* Extra flags pipelines using this backend's layout must be created with
+		*/
+		virtual VkPipelineCreateFlags GetPipelineCreateFlags() const
+		{
+			return 0;
+		}
+
+		/*
+		* Extra usage/allocation flags for buffers written through WriteUniformBuffer/BindTransient
+		*/
+		virtual VkBufferUsageFlags GetRequiredBufferUsage() const
+		{
+			return 0;
+		}
+
+		virtual VkMemoryAllocateFlags GetRequiredAllocateFlags() const
+		{
+			return 0;
+		}
+
+		VkDescriptorSetLayout GetSetLayout() const
+		{
+			return descriptorSetLayout;
+		}
+
+		/*
+		* Adopt a layout created by another backend of the same type and bindings instead of creating one in InitSetLayout.
+		*	!! NOTE !! call before InitSetLayout, the owner destroys the layout
+		*/
+		void ShareSetLayout(VkDescriptorSetLayout sharedSetLayout)
+		{
+			descriptorSetLayout = sharedSetLayout;
+			bSharedSetLayout = true;
+		}
+
+	protected:
+		static void BindTextureTableSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const BindlessTextureTable& textureTable)
+		{
+			VkDescriptorSet textureDescriptorSet = textureTable.GetDescriptorSet();
+			vkCmdBindDescriptorSets
+			(
+				commandBuffer,
+				VK_PIPELINE_BIND_POINT_GRAPHICS,
+				pipelineLayout,
+				1,
+				1,
+				&textureDescriptorSet,
+				0,
+				nullptr
+			);
+		}
+
+		void CreateSetLayout(VkDevice vkDevice, const std::vector<VkDescriptorSetLayoutBinding>& bindings, VkDescriptorSetLayoutCreateFlags flags)
+		{
+			if (bSharedSetLayout)
+			{
+				return;
+			}
+
+			VkDescriptorSetLayoutCreateInfo createInfoDescriptorSetLayout{};
+			createInfoDescriptorSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			createInfoDescriptorSetLayout.flags = flags;
+			createInfoDescriptorSetLayout.bindingCount = static_cast<uint32_t>(bindings.size());
+			createInfoDescriptorSetLayout.pBindings = bindings.data();
+
+			if (vkCreateDescriptorSetLayout(vkDevice, &createInfoDescriptorSetLayout, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create descriptor set layout!");
+			}
+		}
+
+		void DestroySetLayout(VkDevice vkDevice)
+		{
+			if (!bSharedSetLayout)
+			{
+				vkDestroyDescriptorSetLayout(vkDevice, descriptorSetLayout, nullptr);
+			}
+			descriptorSetLayout = VK_NULL_HANDLE;
+		}
+
+	protected:
+		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+		bool bSharedSetLayout = false;
+		std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+	};
+
+	/*
+	* Pool allocated persistent sets, one per frame in flight. Transient sets come from a second per frame pool
+	*/
+	class PooledDescriptorBackend : public DescriptorBackend
+	{
+	public:
+		const char* GetName() const override
+		{
+			return "Pooled";
+		}
+
+		void InitSetLayout(VkDevice vkDevice, const std::vector<VkDescriptorSetLayoutBinding>& bindings) override
+		{
+			layoutBindings = bindings;
+			CreateSetLayout(vkDevice, bindings, 0);
+		}
+
+		void InitPool(VkDevice vkDevice, uint32_t frameCount) override
+		{
+			std::vector<VkDescriptorPoolSize> poolSizes = GetPoolSizes(frameCount);
+
+			VkDescriptorPoolCreateInfo createInfoDescriptorPool{};
+			createInfoDescriptorPool.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			createInfoDescriptorPool.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+			createInfoDescriptorPool.pPoolSizes = poolSizes.data();
+			createInfoDescriptorPool.maxSets = frameCount;
+
+			if (vkCreateDescriptorPool(vkDevice, &createInfoDescriptorPool, nullptr, &descriptorPool) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create descriptor pool!");
+			}
+
+			std::vector<VkDescriptorSetLayout> layouts(frameCount, descriptorSetLayout);
+
+			VkDescriptorSetAllocateInfo allocInfoDescriptorSet{};
+			allocInfoDescriptorSet.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocInfoDescriptorSet.descriptorPool = descriptorPool;
+			allocInfoDescriptorSet.descriptorSetCount = frameCount;
+			allocInfoDescriptorSet.pSetLayouts = layouts.data();
+
+			descriptorSets.resize(frameCount);
+			if (vkAllocateDescriptorSets(vkDevice, &allocInfoDescriptorSet, descriptorSets.data()) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to allocate descriptor sets!");
+			}
+
+			// Transient pools are only created when per draw sets are first requested
+			transientDescriptorPools.resize(frameCount, VK_NULL_HANDLE);
+		}
+
+		void WriteUniformBuffer(VkDevice vkDevice, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) override
+		{
+			WriteSet(vkDevice, descriptorSets[frameIdx], binding, bufferInfo);
+		}
+
+		void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t frameIdx, const BindlessTextureTable& textureTable) override
+		{
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets[frameIdx], 0, nullptr);
+			BindTextureTableSet(commandBuffer, pipelineLayout, textureTable);
+		}
+
+		void BindTransient(VkDevice vkDevice, VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t setIdx, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) override
+		{
+			VkDescriptorPool& transientPool = transientDescriptorPools[frameIdx];
+			if (transientPool == VK_NULL_HANDLE)
+			{
+				std::vector<VkDescriptorPoolSize> poolSizes = GetPoolSizes(MAX_TRANSIENT_DESCRIPTOR_SETS);
+
+				VkDescriptorPoolCreateInfo createInfoDescriptorPool{};
+				createInfoDescriptorPool.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+				createInfoDescriptorPool.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+				createInfoDescriptorPool.pPoolSizes = poolSizes.data();
+				createInfoDescriptorPool.maxSets = MAX_TRANSIENT_DESCRIPTOR_SETS;
+
+				if (vkCreateDescriptorPool(vkDevice, &createInfoDescriptorPool, nullptr, &transientPool) != VK_SUCCESS)
+				{
+					throw std::runtime_error("failed to create transient descriptor pool!");
+				}
+			}
+
+			// the whole set has to be allocated and written even though only one binding differs
+			VkDescriptorSetAllocateInfo allocInfoDescriptorSet{};
+			allocInfoDescriptorSet.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocInfoDescriptorSet.descriptorPool = transientPool;
+			allocInfoDescriptorSet.descriptorSetCount = 1;
+			allocInfoDescriptorSet.pSetLayouts = &descriptorSetLayout;
+
+			VkDescriptorSet transientSet;
+			VkResult allocateRes = vkAllocateDescriptorSets(vkDevice, &allocInfoDescriptorSet, &transientSet);
+			if (allocateRes != VK_SUCCESS)
+			{
+				Vigor::Errors::RaiseRuntimeError("Failed to allocate transient descriptor set Error: {}\n\n", (int)allocateRes);
+			}
+
+			WriteSet(vkDevice, transientSet, binding, bufferInfo);
+
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setIdx, 1, &transientSet, 0, nullptr);
+		}
+
+		void ResetTransient(VkDevice vkDevice, uint32_t frameIdx) override
+		{
+			if (transientDescriptorPools[frameIdx] != VK_NULL_HANDLE)
+			{
+				vkResetDescriptorPool(vkDevice, transientDescriptorPools[frameIdx], 0);
+			}
+		}
+
+		void Shutdown(VkDevice vkDevice) override
+		{
+			for (VkDescriptorPool transientPool : transientDescriptorPools)
+			{
+				vkDestroyDescriptorPool(vkDevice, transientPool, nullptr);
+			}
+
+			vkDestroyDescriptorPool(vkDevice, descriptorPool, nullptr);
+			DestroySetLayout(vkDevice);
+		}
+
+	private:
+		std::vector<VkDescriptorPoolSize> GetPoolSizes(uint32_t setCount) const
+		{
+			std::vector<VkDescriptorPoolSize> poolSizes;
+			for (const VkDescriptorSetLayoutBinding& layoutBinding : layoutBindings)
+			{
+				VkDescriptorPoolSize poolSize{};
+				poolSize.type = layoutBinding.descriptorType;
+				poolSize.descriptorCount = layoutBinding.descriptorCount * setCount;
+				poolSizes.push_back(poolSize);
+			}
+
+			return poolSizes;
+		}
+
+		static void WriteSet(VkDevice vkDevice, VkDescriptorSet descriptorSet, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo)
+		{
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = descriptorSet;
+			descriptorWrite.dstBinding = binding;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pBufferInfo = &bufferInfo;
+
+			vkUpdateDescriptorSets(vkDevice, 1, &descriptorWrite, 0, nullptr);
+		}
+
+	private:
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSet> descriptorSets;
+		std::vector<VkDescriptorPool> transientDescriptorPools;
+	};
+
+	/*
+	* VK_KHR_push_descriptor - bindings are recorded straight into the command buffer,
+	*	no pool or set objects are allocated at all
+	*/
+	class PushDescriptorBackend : public DescriptorBackend
+	{
+	public:
+		const char* GetName() const override
+		{
+			return "Push";
+		}
+
+		void InitSetLayout(VkDevice vkDevice, const std::vector<VkDescriptorSetLayoutBinding>& bindings) override
+		{
+			vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(vkGetDeviceProcAddr(vkDevice, "vkCmdPushDescriptorSetKHR"));
+			if (vkCmdPushDescriptorSetKHR == nullptr)
+			{
+				throw std::runtime_error("Failed to load vkCmdPushDescriptorSetKHR!");
+			}
+
+			layoutBindings = bindings;
+			CreateSetLayout(vkDevice, bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
+		}
+
+		void InitPool(VkDevice vkDevice, uint32_t frameCount) override
+		{
+			frameBufferInfos.resize(frameCount, std::vector<VkDescriptorBufferInfo>(layoutBindings.size()));
+
+			// the writes only point at frameBufferInfos, built once so Bind has nothing to fill in per draw
+			frameDescriptorWrites.resize(frameCount, std::vector<VkWriteDescriptorSet>(layoutBindings.size()));
+			for (uint32_t frameIdx = 0; frameIdx < frameCount; frameIdx++)
+			{
+				for (uint32_t binding = 0; binding < layoutBindings.size(); binding++)
+				{
+					VkWriteDescriptorSet& descriptorWrite = frameDescriptorWrites[frameIdx][binding];
+					descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					descriptorWrite.dstSet = VK_NULL_HANDLE; // ignored for push descriptors
+					descriptorWrite.dstBinding = layoutBindings[binding].binding;
+					descriptorWrite.dstArrayElement = 0;
+					descriptorWrite.descriptorType = layoutBindings[binding].descriptorType;
+					descriptorWrite.descriptorCount = 1;
+					descriptorWrite.pBufferInfo = &frameBufferInfos[frameIdx][binding];
+				}
+			}
+		}
+
+		void WriteUniformBuffer(VkDevice vkDevice, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) override
+		{
+			// nothing to write until bind time, just remember what the frame should push
+			frameBufferInfos[frameIdx][binding] = bufferInfo;
+		}
+
+		void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t frameIdx, const BindlessTextureTable& textureTable) override
+		{
+			const std::vector<VkWriteDescriptorSet>& descriptorWrites = frameDescriptorWrites[frameIdx];
+			vkCmdPushDescriptorSetKHR(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data());
+			BindTextureTableSet(commandBuffer, pipelineLayout, textureTable);
+		}
+
+		void BindTransient(VkDevice vkDevice, VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t setIdx, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) override
+		{
+			// only the changed binding is pushed, the rest of the set stays as previously pushed
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstBinding = binding;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pBufferInfo = &bufferInfo;
+
+			vkCmdPushDescriptorSetKHR(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setIdx, 1, &descriptorWrite);
+		}
+
+		void ResetTransient(VkDevice vkDevice, uint32_t frameIdx) override
+		{
+			// nothing allocated per draw
+		}
+
+		void Shutdown(VkDevice vkDevice) override
+		{
+			DestroySetLayout(vkDevice);
+		}
+
+	private:
+		PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR = nullptr;
+		std::vector<std::vector<VkDescriptorBufferInfo>> frameBufferInfos;
+		std::vector<std::vector<VkWriteDescriptorSet>> frameDescriptorWrites; // parallel to frameBufferInfos
+	};
+
+	/*
+	* VK_EXT_descriptor_buffer - descriptors are written with vkGetDescriptorEXT straight into a host visible
+	*	buffer and bound by address/offset, no pool or set objects exist at all.
+	*
+	* Memory is split per frame in flight: [ persistent set | transient set 0 | ... | transient set N ]
+	*/
+	class DescriptorBufferBackend : public DescriptorBackend
+	{
+	public:
+		DescriptorBufferBackend(VkPhysicalDevice _vkPhysicalDevice)
+			: vkPhysicalDevice(_vkPhysicalDevice)
+		{
+
+		}
+
+		const char* GetName() const override
+		{
+			return "DescriptorBuffer";
+		}
+
+		void InitSetLayout(VkDevice vkDevice, const std::vector<VkDescriptorSetLayoutBinding>& bindings) override
+		{
+			vkGetDescriptorSetLayoutSizeEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetDescriptorSetLayoutSizeEXT"));
+			vkGetDescriptorSetLayoutBindingOffsetEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
+			vkGetDescriptorEXT = reinterpret_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(vkDevice, "vkGetDescriptorEXT"));
+			vkCmdBindDescriptorBuffersEXT = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(vkGetDeviceProcAddr(vkDevice, "vkCmdBindDescriptorBuffersEXT"));
+			vkCmdSetDescriptorBufferOffsetsEXT = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(vkGetDeviceProcAddr(vkDevice, "vkCmdSetDescriptorBufferOffsetsEXT"));
+			if (
+				vkGetDescriptorSetLayoutSizeEXT == nullptr ||
+				vkGetDescriptorSetLayoutBindingOffsetEXT == nullptr ||
+				vkGetDescriptorEXT == nullptr ||
+				vkCmdBindDescriptorBuffersEXT == nullptr ||
+				vkCmdSetDescriptorBufferOffsetsEXT == nullptr)
+			{
+				throw std::runtime_error("Failed to load VK_EXT_descriptor_buffer functions!");
+			}
+
+			VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties{};
+			descriptorBufferProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+
+			VkPhysicalDeviceProperties2 physicalDeviceProperties2{};
+			physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			physicalDeviceProperties2.pNext = &descriptorBufferProperties;
+
+			vkGetPhysicalDeviceProperties2(vkPhysicalDevice, &physicalDeviceProperties2);
+
+			uniformBufferDescriptorSize = descriptorBufferProperties.uniformBufferDescriptorSize;
+
+			layoutBindings = bindings;
+			CreateSetLayout(vkDevice, bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT);
+
+			// every set copy starts on an offset the device can bind
+			VkDeviceSize alignment = descriptorBufferProperties.descriptorBufferOffsetAlignment;
+			vkGetDescriptorSetLayoutSizeEXT(vkDevice, descriptorSetLayout, &setSize);
+			setSize = (setSize + alignment - 1) & ~(alignment - 1);
+
+			bindingOffsets.resize(bindings.size());
+			for (size_t i = 0; i < bindings.size(); i++)
+			{
+				vkGetDescriptorSetLayoutBindingOffsetEXT(vkDevice, descriptorSetLayout, bindings[i].binding, &bindingOffsets[i]);
+			}
+		}
+
+		void InitPool(VkDevice vkDevice, uint32_t frameCount) override
+		{
+			frameSize = setSize * (1 + MAX_TRANSIENT_DESCRIPTOR_SETS);
+			VkDeviceSize bufferSize = frameSize * frameCount;
+
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				bufferSize,
+				VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+				MemoryUsage::Dynamic,
+				descriptorBuffer,
+				descriptorBufferMemory,
+				MemoryCategory::Descriptor,
+				VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+			);
+
+			vkMapMemory(vkDevice, descriptorBufferMemory, 0, bufferSize, 0, &descriptorBufferMapped);
+			descriptorBufferAddress = GetBufferAddress(vkDevice, descriptorBuffer);
+
+			transientSetCounts.resize(frameCount, 0);
+		}
+
+		void WriteUniformBuffer(VkDevice vkDevice, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) override
+		{
+			WriteDescriptor(vkDevice, frameIdx * frameSize, binding, bufferInfo);
+		}
+
+		void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t frameIdx, const BindlessTextureTable& textureTable) override
+		{
+			// both sets have to come from descriptor buffers bound in a single call, binding again replaces every buffer
+			std::array<VkDescriptorBufferBindingInfoEXT, 2> bindingInfos = { GetBindingInfo(), textureTable.GetDescriptorBufferBindingInfo() };
+			vkCmdBindDescriptorBuffersEXT(commandBuffer, static_cast<uint32_t>(bindingInfos.size()), bindingInfos.data());
+			boundCommandBuffer = commandBuffer; // ours is buffer 0, transient sets reuse it without unbinding the texture table
+
+			std::array<uint32_t, 2> bufferIndices = { 0, 1 };
+			std::array<VkDeviceSize, 2> offsets = { frameIdx * frameSize, 0 };
+			vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 2, bufferIndices.data(), offsets.data());
+		}
+
+		void BindTransient(VkDevice vkDevice, VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t setIdx, uint32_t frameIdx, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo) override
+		{
+			uint32_t& transientSetCount = transientSetCounts[frameIdx];
+			if (transientSetCount >= MAX_TRANSIENT_DESCRIPTOR_SETS)
+			{
+				Vigor::Errors::RaiseRuntimeError("Out of transient descriptor buffer space, capacity: {}\n\n", MAX_TRANSIENT_DESCRIPTOR_SETS);
+			}
+
+			// only the changed descriptor is written, the rest of the transient set is left as is
+			VkDeviceSize setOffset = frameIdx * frameSize + setSize * (1 + transientSetCount++);
+			WriteDescriptor(vkDevice, setOffset, binding, bufferInfo);
+
+			// only reached for command buffers Bind never saw, nothing else is bound that this could replace
+			if (boundCommandBuffer != commandBuffer)
+			{
+				VkDescriptorBufferBindingInfoEXT bindingInfo = GetBindingInfo();
+				vkCmdBindDescriptorBuffersEXT(commandBuffer, 1, &bindingInfo);
+				boundCommandBuffer = commandBuffer;
+			}
+
+			uint32_t bufferIdx = 0;
+			vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setIdx, 1, &bufferIdx, &setOffset);
+		}
+
+		void ResetTransient(VkDevice vkDevice, uint32_t frameIdx) override
+		{
+			transientSetCounts[frameIdx] = 0;
+			boundCommandBuffer = VK_NULL_HANDLE;
+			addressCacheBuffer = VK_NULL_HANDLE;
+		}
+
+		void Shutdown(VkDevice vkDevice) override
+		{
+			vkUnmapMemory(vkDevice, descriptorBufferMemory);
+			vkDestroyBuffer(vkDevice, descriptorBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, descriptorBufferMemory);
+			DestroySetLayout(vkDevice);
+		}
+
+		VkPipelineCreateFlags GetPipelineCreateFlags() const override
+		{
+			return VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+		}
+
+		VkBufferUsageFlags GetRequiredBufferUsage() const override
+		{
+			return VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT; // uniform buffer descriptors are built from device addresses
+		}
+
+		VkMemoryAllocateFlags GetRequiredAllocateFlags() const override
+		{
+			return VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+		}
+
+	private:
+		void WriteDescriptor(VkDevice vkDevice, VkDeviceSize setOffset, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo)
+		{
+			auto itBinding = std::find_if(layoutBindings.begin(), layoutBindings.end(), [binding](const VkDescriptorSetLayoutBinding& layoutBinding) { return layoutBinding.binding == binding; });
+			if (itBinding == layoutBindings.end())
+			{
+				Vigor::Errors::RaiseRuntimeError("Descriptor buffer write to unknown binding: {}\n\n", binding);
+			}
+
+			VkDescriptorAddressInfoEXT addressInfo{};
+			addressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+			addressInfo.address = GetCachedBufferAddress(vkDevice, bufferInfo.buffer) + bufferInfo.offset;
+			addressInfo.range = bufferInfo.range;
+			addressInfo.format = VK_FORMAT_UNDEFINED;
+
+			VkDescriptorGetInfoEXT descriptorGetInfo{};
+			descriptorGetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+			descriptorGetInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			descriptorGetInfo.data.pUniformBuffer = &addressInfo;
+
+			VkDeviceSize bindingOffset = bindingOffsets[std::distance(layoutBindings.begin(), itBinding)];
+			uint8_t* descriptor = static_cast<uint8_t*>(descriptorBufferMapped) + setOffset + bindingOffset;
+			vkGetDescriptorEXT(vkDevice, &descriptorGetInfo, uniformBufferDescriptorSize, descriptor);
+		}
+
+		VkDescriptorBufferBindingInfoEXT GetBindingInfo() const
+		{
+			VkDescriptorBufferBindingInfoEXT bindingInfo{};
+			bindingInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+			bindingInfo.address = descriptorBufferAddress;
+			bindingInfo.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+			return bindingInfo;
+		}
+
+		/*
+		* Per draw writes all point into the same uniform buffer, only ask the driver when it changes. Cleared each
+		*	ResetTransient so a destroyed buffer's handle can't be matched later
+		*/
+		VkDeviceAddress GetCachedBufferAddress(VkDevice vkDevice, VkBuffer buffer)
+		{
+			if (buffer != addressCacheBuffer)
+			{
+				addressCacheBuffer = buffer;
+				addressCacheAddress = GetBufferAddress(vkDevice, buffer);
+			}
+
+			return addressCacheAddress;
+		}
+
+		static VkDeviceAddress GetBufferAddress(VkDevice vkDevice, VkBuffer buffer)
+		{
+			VkBufferDeviceAddressInfo bufferDeviceAddressInfo{};
+			bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+			bufferDeviceAddressInfo.buffer = buffer;
+
+			return vkGetBufferDeviceAddress(vkDevice, &bufferDeviceAddressInfo);
+		}
+
+	private:
+		VkPhysicalDevice vkPhysicalDevice;
+
+		VkBuffer descriptorBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory descriptorBufferMemory = VK_NULL_HANDLE;
+		void* descriptorBufferMapped = nullptr;
+		VkDeviceAddress descriptorBufferAddress = 0;
+
+		VkDeviceSize setSize = 0; // aligned size of one set copy
+		VkDeviceSize frameSize = 0;
+		std::vector<VkDeviceSize> bindingOffsets; // parallel to layoutBindings
+		size_t uniformBufferDescriptorSize = 0;
+
+		std::vector<uint32_t> transientSetCounts;
+		VkCommandBuffer boundCommandBuffer = VK_NULL_HANDLE; // skip rebinding the buffer for back to back transient sets
+
+		VkBuffer addressCacheBuffer = VK_NULL_HANDLE;
+		VkDeviceAddress addressCacheAddress = 0;
+
+		PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT = nullptr;
+		PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT = nullptr;
+		PFN_vkGetDescriptorEXT vkGetDescriptorEXT = nullptr;
+		PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffersEXT = nullptr;
+		PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsetsEXT = nullptr;
+	};
+
+	namespace Descriptors
+	{
+		/*
+		* Set 0 bindings shared by every window's graphics pipelines
+		*/
+		static std::vector<VkDescriptorSetLayoutBinding> GetFrameSetBindings()
+		{
+			VkDescriptorSetLayoutBinding mvpBufferLayoutBinding{};
+			mvpBufferLayoutBinding.binding = 0;
+			mvpBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			mvpBufferLayoutBinding.descriptorCount = 1;
+			mvpBufferLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+			mvpBufferLayoutBinding.pImmutableSamplers = nullptr;
+
+			// textures are not bound here, they live in the engine's bindless texture table (set 1)
+			return { mvpBufferLayoutBinding };
+		}
+
+		/*
+		* Resolve Auto to the fastest backend the device supports, requests the device can't honour fall back to pool allocated sets
+		*/
+		static DescriptorBackendType ResolveBackendType(DescriptorBackendType requestedType, const DeviceCapabilities& deviceCapabilities)
+		{
+			switch (requestedType)
+			{
+			case DescriptorBackendType::DescriptorBuffer:
+				return deviceCapabilities.bDescriptorBuffer ? DescriptorBackendType::DescriptorBuffer : DescriptorBackendType::Pooled;
+			case DescriptorBackendType::Push:
+				return deviceCapabilities.bPushDescriptors ? DescriptorBackendType::Push : DescriptorBackendType::Pooled;
+			case DescriptorBackendType::Pooled:
+				return DescriptorBackendType::Pooled;
+			default:
+				break;
+			}
+
+			if (deviceCapabilities.bDescriptorBuffer)
+			{
+				return DescriptorBackendType::DescriptorBuffer;
+			}
+
+			if (deviceCapabilities.bPushDescriptors)
+			{
+				return DescriptorBackendType::Push;
+			}
+
+			return DescriptorBackendType::Pooled;
+		}
+
+		static const char* GetBackendTypeName(DescriptorBackendType backendType)
+		{
+			switch (backendType)
+			{
+			case DescriptorBackendType::DescriptorBuffer:
+				return "DescriptorBuffer";
+			case DescriptorBackendType::Push:
+				return "Push";
+			case DescriptorBackendType::Pooled:
+				return "Pooled";
+			default:
+				return "Auto";
+			}
+		}
+
+		static std::unique_ptr<DescriptorBackend> CreateBackend(DescriptorBackendType backendType, VkPhysicalDevice vkPhysicalDevice)
+		{
+			switch (backendType)
+			{
+			case DescriptorBackendType::DescriptorBuffer:
+				return std::make_unique<DescriptorBufferBackend>(vkPhysicalDevice);
+			case DescriptorBackendType::Push:
+				return std::make_unique<PushDescriptorBackend>();
+			default:
+				return std::make_unique<PooledDescriptorBackend>();
+			}
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace Vigor
+{
+	/*
+	* SPIR-V compiled from shaders/glsl and baked into the binary, so creating a module never touches the disk.
+	*
+	* The include/generated/*.inc word lists come from shaders/glsl/shadercompile.bat (or .sh), which runs as
+	*	the pre-build step. Edit the GLSL, not the generated files.
+	*/
+	namespace EmbeddedShaders
+	{
+		constexpr uint32_t VertexShader[] =
+		{
+#include "generated/shader.vert.inc"
+		};
+
+		constexpr uint32_t FragmentShader[] =
+		{
+#include "generated/shader.frag.inc"
+		};
+
+		struct EmbeddedShader
+		{
+			const char* name;
+			const uint32_t* code;
+			size_t wordCount;
+		};
+
+		constexpr EmbeddedShader Shaders[] =
+		{
+			{ "shader.vert", VertexShader, sizeof(VertexShader) / sizeof(uint32_t) },
+			{ "shader.frag", FragmentShader, sizeof(FragmentShader) / sizeof(uint32_t) },
+		};
+
+		/*
+		* Look up a shader by its GLSL file name, nullptr if it isn't embedded
+		*/
+		static const EmbeddedShader* Find(const std::string& name)
+		{
+			for (const EmbeddedShader& shader : Shaders)
+			{
+				if (name == shader.name)
+				{
+					return &shader;
+				}
+			}
+
+			return nullptr;
+		}
+	}
+}
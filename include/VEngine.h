@@ -2,6 +2,7 @@
 
 #include <set>
 #include <memory>
+#include <cstring>
 #include <vector>
 #include <cassert>
 #include <iostream>
@@ -19,15 +20,27 @@
 #include "VWindow.h"
 #include "VUtilities.h"
 #include "VDefinitions.h"
+#include "VBenchmarks.h"
 #include "VEngineTypes.h"
+#include "VDescriptors.h"
+#include "VPipelines.h"
+#include "VPipelineCache.h"
+#include "VBindlessTextures.h"
+#include "VResources.h"
+#include "VMemoryBudget.h"
+#include "VAttachmentPool.h"
+#include "VFrameLimiter.h"
 
 namespace Vigor
 {
 	class VEngine
 	{
 	public:
-		VEngine(uint8_t _windowCount = 1)
+		VEngine(uint8_t _windowCount = 1, DescriptorBackendType _descriptorBackendType = DescriptorBackendType::Auto, LatencyProfile _latencyProfile = LatencyProfile::HighThroughput, PresentPolicy _presentPolicy = PresentPolicy::Mailbox)
 			: windowCount(_windowCount)
+			, descriptorBackendType(_descriptorBackendType)
+			, latencyProfile(_latencyProfile)
+			, presentPolicy(_presentPolicy)
 		{
 			// TODO[CC] Initialize with delegates for more elegant setup
 
@@ -41,40 +54,55 @@ namespace Vigor
 
 			InitVKPhysicalDevice();
 
+			InitDeviceCapabilities();
+
 			InitQueueFamilies();
 
 			InitLogicalDevice();
 
+			Memory::Budget().Init(vkPhysicalDevice, deviceCapabilities.bMemoryBudget);
+
+			textureTable.Init(vkDevice, vkPhysicalDevice, descriptorBackendType == DescriptorBackendType::DescriptorBuffer);
+			resourceManager.Init(vkDevice, vkPhysicalDevice, queueFamilyIndicies, deviceCapabilities, textureTable);
+
+			pipelineCache.Init(vkDevice, vkPhysicalDevice, PIPELINE_CACHE_PATH);
+			pipelineCompileService.Init(vkDevice, pipelineCache, deviceCapabilities.bGraphicsPipelineLibrary);
+			pipelineRegistry.Init(vkDevice, vkPhysicalDevice, pipelineCompileService, descriptorBackendType, textureTable.GetSetLayout(), PIPELINE_MANIFEST_PATH, deviceCapabilities.bDynamicRendering);
+
+#if VIGOR_RUNTIME_SHADER_COMPILATION
+			shaderCompiler.Init(SHADER_SOURCE_PATH, SHADER_CACHE_PATH);
+			pipelineRegistry.SetShaderCompiler(&shaderCompiler);
+#endif // VIGOR_RUNTIME_SHADER_COMPILATION
+
+			// builds last session's pipelines on the workers while the rest of the engine initializes
+			pipelineRegistry.Prewarm();
+
+			SDL_Log("Latency profile: %s", FrameProfile::GetName(latencyProfile));
+
 			// Handle Frame Data
 			for (auto& window : windows)
 			{
+				window->SetFrameProfile(FrameProfile::FromLatencyProfile(latencyProfile));
+				window->SetPresentPolicy(presentPolicy);
+				window->InitPresentWait(vkDevice, deviceCapabilities.bPresentWait);
 				window->InitSwapChain(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies);
 				window->InitImageViews(vkDevice);
-				window->InitRenderPass(vkDevice, vkPhysicalDevice, msaaSamples);
-				window->InitDescriptorSetLayout(vkDevice);
-				window->InitGraphicsPipelineAndLayoutAndShaderModules(vkDevice, msaaSamples);
+				window->InitRenderPass(vkPhysicalDevice, msaaSamples, pipelineRegistry);
+				window->InitGraphicsPipelineAndLayoutAndShaderModules(vkPhysicalDevice, msaaSamples, pipelineRegistry);
 
 				FrameData& frameData = window->GetFrameData();
 
 				frameData.InitCommandPool(vkDevice, queueFamilyIndicies);
 				frameData.InitCommandPoolTransient(vkDevice, queueFamilyIndicies);
 
-				window->InitColorResources(vkDevice, vkPhysicalDevice, msaaSamples);
-				window->InitDepthBufferResources(vkDevice, vkPhysicalDevice, msaaSamples);
+				window->InitColorResources(vkDevice, vkPhysicalDevice, msaaSamples, attachmentPool);
+				window->InitDepthBufferResources(vkDevice, vkPhysicalDevice, msaaSamples, attachmentPool);
+				window->LogAttachmentMemory(vkDevice);
 
 				window->InitFrameBuffers(vkDevice);
-				window->InitTextureImage(vkDevice, vkPhysicalDevice, TEXTURE_PATH);
-				window->InitTextureImageView(vkDevice, vkPhysicalDevice);
-				window->InitTextureSampler(vkDevice, vkPhysicalDevice);
-				window->LoadModel(vkDevice, vkPhysicalDevice, MODEL_PATH);
-				window->InitVertexBuffer(vkDevice, vkPhysicalDevice); // HANDLE VERTEX BUFFER INIT
-				window->InitIndexBuffer(vkDevice, vkPhysicalDevice); // HANDLE INDEX BUFFER INIT
-				window->InitUniformBuffers(vkDevice, vkPhysicalDevice);
-				window->InitDescriptorPool(vkDevice, vkPhysicalDevice);
-				window->InitDescriptorSets(vkDevice, vkPhysicalDevice);
-
-				frameData.InitCommandBuffers(vkDevice);
-				frameData.InitSyncObjects(vkDevice);
+				window->InitResources(resourceManager, MODEL_PATH, TEXTURE_PATH);
+
+				InitWindowFrameResources(*window);
 			}
 		}
 
@@ -83,6 +111,14 @@ namespace Vigor
 			ShutdownWindows();
 			windows.clear();
 
+			pipelineRegistry.Shutdown();
+			pipelineCompileService.Shutdown();
+
+			resourceManager.Shutdown();
+			attachmentPool.Shutdown(vkDevice);
+			textureTable.Shutdown(vkDevice);
+			pipelineCache.Shutdown(vkDevice);
+
 			vkDestroyDevice(vkDevice, nullptr);
 
 #if VULKAN_VALIDATION_LAYERS_ENABLED
@@ -118,7 +154,7 @@ namespace Vigor
 							switch (windowEvent.window.event)
 							{
 							case SDL_WINDOWEVENT_CLOSE:
-								(*itWindow)->Shutdown(vkInstance, vkDevice);
+								(*itWindow)->Shutdown(vkInstance, vkDevice, resourceManager, pipelineRegistry);
 								windows.erase(itWindow);
 								break;
 							case SDL_WINDOWEVENT_MINIMIZED:
@@ -139,6 +175,18 @@ namespace Vigor
 						}
 					}
 
+					// L cycles the latency profiles
+					if (windowEvent.type == SDL_KEYDOWN && windowEvent.key.keysym.sym == SDLK_l && windowEvent.key.repeat == 0)
+					{
+						SetLatencyProfile(static_cast<LatencyProfile>((static_cast<int>(latencyProfile) + 1) % 3));
+					}
+
+					// P cycles the present policies
+					if (windowEvent.type == SDL_KEYDOWN && windowEvent.key.keysym.sym == SDLK_p && windowEvent.key.repeat == 0)
+					{
+						SetPresentPolicy(static_cast<PresentPolicy>((static_cast<int>(presentPolicy) + 1) % static_cast<int>(PresentPolicy::Count)));
+					}
+
 					if (windowEvent.type == SDL_QUIT)
 					{
 						running = false;
@@ -151,14 +199,95 @@ namespace Vigor
 				{
 					if (!window->bIsMinimized)
 					{
-						window->DrawFrame(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies, msaaSamples);
+						window->DrawFrame(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies, msaaSamples, textureTable, resourceManager);
 					}
 				}
+
+				// every window has reported what it drew, stream towards it within what the device can spare
+				Memory::Budget().Update();
+				resourceManager.UpdateStreaming(FrameProfile::FromLatencyProfile(latencyProfile).framesInFlight);
+				attachmentPool.Trim(vkDevice);
+
+				frameLimiter.Wait();
 			}
 
 			vkDeviceWaitIdle(vkDevice);
 		}
 
+		/*
+		* Change frames in flight and swapchain depth at runtime. Each window waits on its own frames, rebuilds what is
+		*	sized per frame and recreates its swapchain on its next frame
+		*/
+		void SetLatencyProfile(LatencyProfile _latencyProfile)
+		{
+			latencyProfile = _latencyProfile;
+
+			for (auto& window : windows)
+			{
+				window->ShutdownFrameResources(vkDevice);
+				window->SetFrameProfile(FrameProfile::FromLatencyProfile(latencyProfile));
+				InitWindowFrameResources(*window);
+			}
+
+			SDL_Log("Latency profile: %s", FrameProfile::GetName(latencyProfile));
+		}
+
+		/*
+		* Present mode every window asks for, applied by recreating each swapchain on its next frame
+		*/
+		void SetPresentPolicy(PresentPolicy _presentPolicy)
+		{
+			presentPolicy = _presentPolicy;
+
+			for (auto& window : windows)
+			{
+				window->SetPresentPolicy(presentPolicy);
+			}
+		}
+
+		/*
+		* Cap the loop at targetFps with the sleep limiter, 0 uncaps. FIFO modes are paced by the display already
+		*	(on present wait where the device has it), the cap is for running below refresh or capping mailbox/immediate
+		*/
+		void SetFrameRateCap(double targetFps)
+		{
+			frameLimiter.SetTargetFps(targetFps);
+
+			if (frameLimiter.IsCapped())
+			{
+				SDL_Log("Frame rate cap: %.1f fps", targetFps);
+			}
+			else
+			{
+				SDL_Log("Frame rate cap: uncapped");
+			}
+		}
+
+		/*
+		* Compare per draw descriptor update throughput of every backend the device supports
+		*/
+		void RunDescriptorBenchmark(uint32_t drawCount = 1000000)
+		{
+			std::vector<std::unique_ptr<DescriptorBackend>> descriptorBackends;
+			descriptorBackends.push_back(std::make_unique<PooledDescriptorBackend>());
+
+			if (deviceCapabilities.bPushDescriptors)
+			{
+				descriptorBackends.push_back(std::make_unique<PushDescriptorBackend>());
+			}
+
+			if (deviceCapabilities.bDescriptorBuffer)
+			{
+				descriptorBackends.push_back(std::make_unique<DescriptorBufferBackend>(vkPhysicalDevice));
+			}
+
+			for (auto& descriptorBackend : descriptorBackends)
+			{
+				double updatesPerMs = Benchmarks::DescriptorUpdatesPerMillisecond(vkDevice, vkPhysicalDevice, queueFamilyIndicies, *descriptorBackend, drawCount);
+				SDL_Log("Descriptor benchmark [%s]: %.1f descriptors updated per ms (%u draws)", descriptorBackend->GetName(), updatesPerMs, drawCount);
+			}
+		}
+
 		static VkSampleCountFlagBits GetMaxUsableSampleCount(VkPhysicalDevice vkPhysicalDevice)
 		{
 			VkPhysicalDeviceProperties physicalDeviceProperties;
@@ -306,6 +435,12 @@ namespace Vigor
 						return false;
 					}
 
+					// Force descriptor indexing requirements for the bindless texture table
+					if (!BindlessTextureTable::IsSupported(vkPhysicalDevice))
+					{
+						return false;
+					}
+
 					// CheckDeviceExtensionSupport
 					if (bResult) // TODO[CC] Do this more elegantly
 					{
@@ -375,6 +510,148 @@ namespace Vigor
 			}
 		}
 
+		void InitDeviceCapabilities()
+		{
+			uint32_t extensionCount = 0;
+			vkEnumerateDeviceExtensionProperties(vkPhysicalDevice, nullptr, &extensionCount, nullptr);
+
+			std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+			vkEnumerateDeviceExtensionProperties(vkPhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+			auto IsExtensionAvailable = [&availableExtensions = availableExtensions](const char* extensionName)
+				{
+					return std::any_of(availableExtensions.begin(), availableExtensions.end(), [extensionName](const VkExtensionProperties& extension) { return strcmp(extension.extensionName, extensionName) == 0; });
+				};
+
+			// Optional extensions are enabled when present, features fall back when not
+			if (IsExtensionAvailable(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME))
+			{
+				deviceExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+				deviceCapabilities.bPushDescriptors = true;
+			}
+
+			if (IsExtensionAvailable(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+			{
+				VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{};
+				descriptorBufferFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+
+				VkPhysicalDeviceVulkan12Features vulkan12Features{};
+				vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+				vulkan12Features.pNext = &descriptorBufferFeatures;
+
+				VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
+				physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				physicalDeviceFeatures2.pNext = &vulkan12Features;
+
+				vkGetPhysicalDeviceFeatures2(vkPhysicalDevice, &physicalDeviceFeatures2);
+
+				// the texture table writes its array assuming combined image samplers are packed one after another
+				VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties{};
+				descriptorBufferProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+
+				VkPhysicalDeviceProperties2 physicalDeviceProperties2{};
+				physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+				physicalDeviceProperties2.pNext = &descriptorBufferProperties;
+
+				vkGetPhysicalDeviceProperties2(vkPhysicalDevice, &physicalDeviceProperties2);
+
+				if (
+					descriptorBufferFeatures.descriptorBuffer == VK_TRUE &&
+					vulkan12Features.bufferDeviceAddress == VK_TRUE &&
+					descriptorBufferProperties.combinedImageSamplerDescriptorSingleArray == VK_TRUE)
+				{
+					deviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+					deviceCapabilities.bDescriptorBuffer = true;
+				}
+			}
+
+			if (IsExtensionAvailable(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) && IsExtensionAvailable(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME))
+			{
+				VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+				graphicsPipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+				VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
+				physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				physicalDeviceFeatures2.pNext = &graphicsPipelineLibraryFeatures;
+
+				vkGetPhysicalDeviceFeatures2(vkPhysicalDevice, &physicalDeviceFeatures2);
+
+				if (graphicsPipelineLibraryFeatures.graphicsPipelineLibrary == VK_TRUE)
+				{
+					deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+					deviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+					deviceCapabilities.bGraphicsPipelineLibrary = true;
+				}
+			}
+
+			if (IsExtensionAvailable(VK_KHR_PRESENT_ID_EXTENSION_NAME) && IsExtensionAvailable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+			{
+				VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+				presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+				VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+				presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+				presentIdFeatures.pNext = &presentWaitFeatures;
+
+				VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
+				physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				physicalDeviceFeatures2.pNext = &presentIdFeatures;
+
+				vkGetPhysicalDeviceFeatures2(vkPhysicalDevice, &physicalDeviceFeatures2);
+
+				if (presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE)
+				{
+					deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+					deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+					deviceCapabilities.bPresentWait = true;
+				}
+			}
+
+			if (IsExtensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+			{
+				deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+				deviceCapabilities.bMemoryBudget = true;
+			}
+
+			VkPhysicalDeviceFeatures physicalDeviceFeatures;
+			vkGetPhysicalDeviceFeatures(vkPhysicalDevice, &physicalDeviceFeatures);
+			deviceCapabilities.bTextureCompressionBC = physicalDeviceFeatures.textureCompressionBC == VK_TRUE;
+
+			// core in 1.3 but still a feature bit, and the instance asking for 1.3 says nothing about the device
+			VkPhysicalDeviceProperties physicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(vkPhysicalDevice, &physicalDeviceProperties);
+			if (physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_3)
+			{
+				VkPhysicalDeviceVulkan13Features vulkan13Features{};
+				vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+				VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
+				physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				physicalDeviceFeatures2.pNext = &vulkan13Features;
+
+				vkGetPhysicalDeviceFeatures2(vkPhysicalDevice, &physicalDeviceFeatures2);
+
+				deviceCapabilities.bDynamicRendering = vulkan13Features.dynamicRendering == VK_TRUE;
+			}
+
+			SDL_Log("Push descriptors: %s", deviceCapabilities.bPushDescriptors ? "enabled" : "unavailable");
+			SDL_Log("Descriptor buffers: %s", deviceCapabilities.bDescriptorBuffer ? "enabled" : "unavailable");
+			SDL_Log("Graphics pipeline libraries: %s", deviceCapabilities.bGraphicsPipelineLibrary ? "enabled" : "unavailable");
+			SDL_Log("BC texture compression: %s", deviceCapabilities.bTextureCompressionBC ? "enabled" : "unavailable");
+			SDL_Log("Memory budget: %s", deviceCapabilities.bMemoryBudget ? "enabled" : "unavailable, estimating from heap sizes");
+			SDL_Log("Dynamic rendering: %s", deviceCapabilities.bDynamicRendering ? "enabled" : "unavailable, using render passes");
+			SDL_Log("Present wait: %s", deviceCapabilities.bPresentWait ? "enabled" : "unavailable, pacing with the frame limiter only");
+
+			DescriptorBackendType requestedBackendType = descriptorBackendType;
+			descriptorBackendType = Descriptors::ResolveBackendType(requestedBackendType, deviceCapabilities);
+			if (requestedBackendType != DescriptorBackendType::Auto && requestedBackendType != descriptorBackendType)
+			{
+				SDL_Log("Requested descriptor backend is not supported by this device, falling back");
+			}
+
+			SDL_Log("Descriptor backend: %s", Descriptors::GetBackendTypeName(descriptorBackendType));
+		}
+
 		void InitQueueFamilies()
 		{
 			uint32_t queueFamilyCount;
@@ -433,10 +710,63 @@ namespace Vigor
 			VkPhysicalDeviceFeatures deviceFeatures = {};
 			deviceFeatures.samplerAnisotropy = VK_TRUE; // enable anisotropic filtering support on samplers
 			deviceFeatures.sampleRateShading = VK_TRUE; // enable sample shading feature for the device
+			deviceFeatures.textureCompressionBC = deviceCapabilities.bTextureCompressionBC ? VK_TRUE : VK_FALSE; // baked BCn textures
+
+			// Vulkan 1.2 descriptor indexing features for the bindless texture table
+			VkPhysicalDeviceVulkan12Features vulkan12Features{};
+			vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+			BindlessTextureTable::EnableRequiredFeatures(vulkan12Features);
+
+			// descriptor buffers hold raw device addresses
+			VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{};
+			descriptorBufferFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+			if (deviceCapabilities.bDescriptorBuffer)
+			{
+				descriptorBufferFeatures.descriptorBuffer = VK_TRUE;
+				descriptorBufferFeatures.pNext = vulkan12Features.pNext;
+				vulkan12Features.bufferDeviceAddress = VK_TRUE;
+				vulkan12Features.pNext = &descriptorBufferFeatures;
+			}
+
+			// pipelines are linked from separately compiled vertex input, pre-rasterization, fragment and output parts
+			VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+			graphicsPipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+			if (deviceCapabilities.bGraphicsPipelineLibrary)
+			{
+				graphicsPipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+				graphicsPipelineLibraryFeatures.pNext = vulkan12Features.pNext;
+				vulkan12Features.pNext = &graphicsPipelineLibraryFeatures;
+			}
+
+			// presents are tagged with ids and FIFO windows wait on them for pacing
+			VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+			presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+			VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+			presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+			if (deviceCapabilities.bPresentWait)
+			{
+				presentWaitFeatures.presentWait = VK_TRUE;
+				presentIdFeatures.presentId = VK_TRUE;
+				presentIdFeatures.pNext = &presentWaitFeatures;
+				presentWaitFeatures.pNext = vulkan12Features.pNext;
+				vulkan12Features.pNext = &presentIdFeatures;
+			}
+
+			// windows render without render pass or framebuffer objects
+			VkPhysicalDeviceVulkan13Features vulkan13Features{};
+			vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+			if (deviceCapabilities.bDynamicRendering)
+			{
+				vulkan13Features.dynamicRendering = VK_TRUE;
+				vulkan13Features.pNext = vulkan12Features.pNext;
+				vulkan12Features.pNext = &vulkan13Features;
+			}
+
 			VkDeviceCreateInfo deviceCreateInfo =
 			{
 				VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,           // sType
-				nullptr,                                        // pNext
+				&vulkan12Features,                              // pNext
 				0,                                              // flags
 				1,                                              // queueCreateInfoCount // TODO - should be size of vector of deviceQueueCreateInfos (doesnt exist yet)
 				&deviceQueueCreateInfo,                         // pQueueCreateInfos // TODO - can point to data ptr of vector
@@ -466,19 +796,41 @@ namespace Vigor
 			SDL_Log("Initialized with errors: %s", SDL_GetError());
 		}
 
+		/*
+		* Uniform buffers, descriptors, command buffers and sync objects, one of each per frame in flight
+		*/
+		void InitWindowFrameResources(VWindow& window)
+		{
+			window.InitDescriptorSetLayout(vkDevice, vkPhysicalDevice, descriptorBackendType, pipelineRegistry.GetFrameSetLayout());
+			window.InitUniformBuffers(vkDevice, vkPhysicalDevice);
+			window.InitDescriptorPool(vkDevice, vkPhysicalDevice);
+			window.InitDescriptorSets(vkDevice, vkPhysicalDevice);
+
+			FrameData& frameData = window.GetFrameData();
+			frameData.InitCommandBuffers(vkDevice, window.GetFrameProfile().framesInFlight);
+			frameData.InitSyncObjects(vkDevice, window.GetFrameProfile().framesInFlight);
+		}
+
 		// Shutdown
 		void ShutdownWindows()
 		{
 			// TODO[CC] make 1 line-r
 			for (auto& window : windows)
 			{
-				window->Shutdown(vkInstance, vkDevice);
+				window->Shutdown(vkInstance, vkDevice, resourceManager, pipelineRegistry);
 			}
 		}
 
 	private:
 		uint8_t windowCount = 1;
 
+		DescriptorBackendType descriptorBackendType = DescriptorBackendType::Auto; // resolved once device capabilities are known
+		LatencyProfile latencyProfile = LatencyProfile::HighThroughput;
+		PresentPolicy presentPolicy = PresentPolicy::Mailbox;
+
+		// Sleep based cap on the loop, uncapped unless SetFrameRateCap is called
+		FrameLimiter frameLimiter;
+
 		VkInstance vkInstance;
 
 		VkDevice vkDevice;
@@ -488,15 +840,43 @@ namespace Vigor
 
 		QueueFamilyIndicies queueFamilyIndicies;
 		SwapChainSupportDetails swapChainSupportDetails;
+		DeviceCapabilities deviceCapabilities;
 
 		std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
 		const std::string MODEL_PATH = "./assets/models/viking_room.3dobj";
 		const std::string TEXTURE_PATH = "./assets/textures/viking_room.png";
+		const std::string PIPELINE_CACHE_PATH = "./cache/pipeline_cache.bin";
+		const std::string PIPELINE_MANIFEST_PATH = "./cache/pipeline_manifest.txt";
+		const std::string SHADER_SOURCE_PATH = "./shaders/glsl";
+		const std::string SHADER_CACHE_PATH = "./cache/spirv";
 
 		// MSAA
 		VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
 
+		// Global texture array shared by every window
+		BindlessTextureTable textureTable;
+
+		// Meshes and textures loaded once and shared by every window
+		ResourceManager resourceManager;
+
+		// Render target memory shared by every window, kept across swapchain recreation
+		AttachmentPool attachmentPool;
+
+		// Driver pipeline cache shared by every window, persisted to PIPELINE_CACHE_PATH
+		PipelineCache pipelineCache;
+
+		// Background pipeline builds for every window
+		PipelineCompileService pipelineCompileService;
+
+		// Deduplicated pipelines shared by every window, pre-warmed from PIPELINE_MANIFEST_PATH
+		PipelineRegistry pipelineRegistry;
+
+#if VIGOR_RUNTIME_SHADER_COMPILATION
+		// GLSL from SHADER_SOURCE_PATH compiled on demand, SPIR-V cached in SHADER_CACHE_PATH
+		ShaderCompiler shaderCompiler;
+#endif // VIGOR_RUNTIME_SHADER_COMPILATION
+
 #if VULKAN_VALIDATION_LAYERS_ENABLED
 		std::vector<const char*> validationLayerNames;
 #endif // VULKAN_VALIDATION_LAYERS_ENABLED
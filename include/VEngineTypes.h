@@ -39,6 +39,121 @@ namespace Vigor
         }
     };
 
+    /*
+    * Optional device functionality detected at physical device selection
+    */
+    struct DeviceCapabilities
+    {
+        bool bPushDescriptors = false; // VK_KHR_push_descriptor
+        bool bDescriptorBuffer = false; // VK_EXT_descriptor_buffer + buffer device address
+        bool bGraphicsPipelineLibrary = false; // VK_EXT_graphics_pipeline_library + VK_KHR_pipeline_library
+        bool bTextureCompressionBC = false; // textureCompressionBC, baked BCn textures can be sampled directly
+        bool bMemoryBudget = false; // VK_EXT_memory_budget
+        bool bDynamicRendering = false; // Vulkan 1.3 dynamicRendering, no render pass or framebuffer objects
+        bool bPresentWait = false; // VK_KHR_present_id + VK_KHR_present_wait
+    };
+
+    /*
+    * How per frame/per draw descriptors reach the GPU, Auto picks the best the device supports
+    */
+    enum class DescriptorBackendType
+    {
+        Auto,
+        Pooled, // descriptor pools and sets
+        Push, // VK_KHR_push_descriptor
+        DescriptorBuffer // VK_EXT_descriptor_buffer
+    };
+
+    /*
+    * Latency against throughput, how far the CPU may run ahead of the GPU and how deep the swapchain is
+    */
+    enum class LatencyProfile
+    {
+        LowLatency, // 1 frame in flight, minimum swapchain images, late acquire
+        Balanced, // 2 frames in flight
+        HighThroughput // 3 frames in flight, one slow frame never stalls the CPU
+    };
+
+    struct FrameProfile
+    {
+        uint32_t framesInFlight = 3;
+        uint32_t extraSwapchainImages = 1; // on top of the surface's minImageCount
+        bool bLateAcquire = false; // the frame's CPU work is done before acquiring, the image is held for as short as possible
+
+        static FrameProfile FromLatencyProfile(LatencyProfile latencyProfile)
+        {
+            switch (latencyProfile)
+            {
+            case LatencyProfile::LowLatency:
+                return { 1, 0, true };
+            case LatencyProfile::Balanced:
+                return { 2, 1, false };
+            default:
+                return { 3, 1, false };
+            }
+        }
+
+        static const char* GetName(LatencyProfile latencyProfile)
+        {
+            switch (latencyProfile)
+            {
+            case LatencyProfile::LowLatency:
+                return "low latency";
+            case LatencyProfile::Balanced:
+                return "balanced";
+            default:
+                return "high throughput";
+            }
+        }
+    };
+
+    /*
+    * Which present mode swapchains ask for, FIFO is used when the surface doesn't offer it
+    */
+    enum class PresentPolicy
+    {
+        Fifo, // vsync, every image is shown
+        FifoRelaxed, // vsync, a late image tears instead of waiting another refresh
+        Mailbox, // vsync without blocking, the newest image replaces a queued one
+        Immediate, // no vsync, uncapped throughput
+        Count
+    };
+
+    static VkPresentModeKHR GetPresentMode(PresentPolicy presentPolicy)
+    {
+        switch (presentPolicy)
+        {
+        case PresentPolicy::FifoRelaxed:
+            return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        case PresentPolicy::Mailbox:
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        case PresentPolicy::Immediate:
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        default:
+            return VK_PRESENT_MODE_FIFO_KHR;
+        }
+    }
+
+    static const char* GetPresentModeName(VkPresentModeKHR presentMode)
+    {
+        switch (presentMode)
+        {
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            return "FIFO relaxed";
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return "mailbox";
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return "immediate";
+        default:
+            return "FIFO";
+        }
+    }
+
+    struct DrawPushConstants
+    {
+        uint32_t materialIndex; // slot in the bindless texture table
+    };
+
     struct Vertex 
     {
         glm::vec3 pos;
@@ -1,7 +1,26 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <cstdint>
 #include <fstream>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 namespace Vigor
 {
@@ -28,5 +47,200 @@ namespace Vigor
             file.close();
             return buffer;
         }
+
+        /*
+        * Non throwing Read for optional files such as caches, returns false if the file is missing or unreadable
+        */
+        static bool TryRead(const std::string& filename, std::vector<char>& outBuffer)
+        {
+            std::ifstream file(filename, std::ios::ate | std::ios::binary);
+            if (!file.is_open())
+            {
+                return false;
+            }
+
+            size_t fileSize = (size_t)file.tellg();
+            outBuffer.resize(fileSize);
+
+            file.seekg(0);
+            file.read(outBuffer.data(), fileSize);
+
+            return file.good();
+        }
+
+        /*
+        * Write to a temporary file then rename over the destination,
+        *   a crash mid write leaves the previous file intact instead of a truncated one
+        */
+        static bool WriteAtomic(const std::string& filename, const void* data, size_t size)
+        {
+            std::filesystem::path filePath(filename);
+            std::filesystem::path tempPath = filePath;
+            tempPath += ".tmp";
+
+            std::error_code errorCode;
+            if (filePath.has_parent_path())
+            {
+                std::filesystem::create_directories(filePath.parent_path(), errorCode);
+            }
+
+            {
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                if (!file.is_open())
+                {
+                    return false;
+                }
+
+                file.write(static_cast<const char*>(data), size);
+                file.flush();
+                if (!file.good())
+                {
+                    file.close();
+                    std::filesystem::remove(tempPath, errorCode);
+                    return false;
+                }
+            }
+
+            std::filesystem::rename(tempPath, filePath, errorCode); // replaces an existing destination
+            if (errorCode)
+            {
+                std::filesystem::remove(tempPath, errorCode);
+                return false;
+            }
+
+            return true;
+        }
+
+        /*
+        * Read only view of a whole file mapped into the address space, pages come straight from the OS file cache
+        *   so large assets can be copied to their destination without first being read into a heap buffer
+        */
+        class MappedFile
+        {
+        public:
+            MappedFile() = default;
+
+            ~MappedFile()
+            {
+                Close();
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            bool Open(const std::string& filename)
+            {
+                Close();
+
+#ifdef _WIN32
+                fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (fileHandle == INVALID_HANDLE_VALUE)
+                {
+                    return false;
+                }
+
+                LARGE_INTEGER fileSize;
+                if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+                {
+                    Close();
+                    return false;
+                }
+
+                mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mappingHandle == nullptr)
+                {
+                    Close();
+                    return false;
+                }
+
+                data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+                size = static_cast<size_t>(fileSize.QuadPart);
+#else
+                fileDescriptor = open(filename.c_str(), O_RDONLY);
+                if (fileDescriptor < 0)
+                {
+                    return false;
+                }
+
+                struct stat fileStat;
+                if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+                {
+                    Close();
+                    return false;
+                }
+
+                void* mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+                if (mapping == MAP_FAILED)
+                {
+                    Close();
+                    return false;
+                }
+
+                madvise(mapping, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+
+                data = static_cast<const uint8_t*>(mapping);
+                size = static_cast<size_t>(fileStat.st_size);
+#endif
+                if (data == nullptr)
+                {
+                    Close();
+                    return false;
+                }
+
+                return true;
+            }
+
+            void Close()
+            {
+#ifdef _WIN32
+                if (data != nullptr)
+                {
+                    UnmapViewOfFile(data);
+                }
+                if (mappingHandle != nullptr)
+                {
+                    CloseHandle(mappingHandle);
+                    mappingHandle = nullptr;
+                }
+                if (fileHandle != INVALID_HANDLE_VALUE)
+                {
+                    CloseHandle(fileHandle);
+                    fileHandle = INVALID_HANDLE_VALUE;
+                }
+#else
+                if (data != nullptr)
+                {
+                    munmap(const_cast<uint8_t*>(data), size);
+                }
+                if (fileDescriptor >= 0)
+                {
+                    close(fileDescriptor);
+                    fileDescriptor = -1;
+                }
+#endif
+                data = nullptr;
+                size = 0;
+            }
+
+            const uint8_t* Data() const
+            {
+                return data;
+            }
+
+            size_t Size() const
+            {
+                return size;
+            }
+
+        private:
+#ifdef _WIN32
+            HANDLE fileHandle = INVALID_HANDLE_VALUE;
+            HANDLE mappingHandle = nullptr;
+#else
+            int fileDescriptor = -1;
+#endif
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+        };
     }
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+namespace Vigor
+{
+	/*
+	* Caps the engine loop at a target rate, the fallback pacing when the device has no VK_KHR_present_wait and the way to
+	*	cap MAILBOX/IMMEDIATE below the display's refresh.
+	*
+	* The OS sleep is only trusted to within SpinThreshold (a scheduler tick can be a millisecond or more), the rest of the
+	*	wait spins so frames land on the deadline rather than somewhere after it. Deadlines advance by the frame period
+	*	from the previous deadline, not from when the frame finished, so the average rate holds even with jitter.
+	*/
+	class FrameLimiter
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr std::chrono::microseconds SpinThreshold{ 2000 };
+
+		FrameLimiter()
+			: framePeriod(Clock::duration::zero())
+			, nextFrameTime()
+		{
+
+		}
+
+		/*
+		* 0 or less uncaps
+		*/
+		void SetTargetFps(double targetFps)
+		{
+			framePeriod = targetFps > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps)) : Clock::duration::zero();
+			nextFrameTime = Clock::now();
+		}
+
+		bool IsCapped() const
+		{
+			return framePeriod > Clock::duration::zero();
+		}
+
+		/*
+		* Once per loop, returns when the next frame may start
+		*/
+		void Wait()
+		{
+			if (!IsCapped())
+			{
+				return;
+			}
+
+			nextFrameTime += framePeriod;
+
+			Clock::time_point now = Clock::now();
+			if (nextFrameTime < now - framePeriod)
+			{
+				nextFrameTime = now; // fell more than a frame behind (a hitch, a resize), don't burst to catch up
+				return;
+			}
+
+			if (nextFrameTime - now > SpinThreshold)
+			{
+				std::this_thread::sleep_for(nextFrameTime - now - SpinThreshold);
+			}
+
+			while (Clock::now() < nextFrameTime)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		Clock::duration framePeriod;
+		Clock::time_point nextFrameTime;
+	};
+}
@@ -0,0 +1,424 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VMemory.h"
+
+namespace Vigor
+{
+	/*
+	* Image creation and one-off upload commands shared by windows and the resource manager.
+	*	Commands are recorded into commandPool and submitted to graphicsQueue, waiting until they complete
+	*/
+	namespace Images
+	{
+		static bool FormatHasStencilComponent(VkFormat format)
+		{
+			return format == VK_FORMAT_D32_SFLOAT_S8_UINT ||
+				format == VK_FORMAT_D24_UNORM_S8_UINT;
+		}
+
+		/*
+		* The image alone, no memory bound, for callers that place it in memory they already own
+		*/
+		static void CreateUnboundImage
+		(
+			VkDevice vkDevice,
+			uint32_t texWidth,
+			uint32_t texHeight,
+			uint32_t mipLevels,
+			VkSampleCountFlagBits numSamples,
+			VkFormat format,
+			VkImageTiling tiling,
+			VkImageUsageFlags usage,
+			VkImage& image
+		)
+		{
+			VkImageCreateInfo createInfoImage{};
+			createInfoImage.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			createInfoImage.imageType = VK_IMAGE_TYPE_2D;
+			createInfoImage.extent.width = static_cast<uint32_t>(texWidth);
+			createInfoImage.extent.height = static_cast<uint32_t>(texHeight);
+			createInfoImage.extent.depth = 1;
+			createInfoImage.mipLevels = 1;
+			createInfoImage.arrayLayers = 1;
+			createInfoImage.format = format;
+			createInfoImage.tiling = tiling;
+			createInfoImage.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			createInfoImage.usage = usage;
+			createInfoImage.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			createInfoImage.samples = numSamples;
+			createInfoImage.flags = 0; // Optional
+			createInfoImage.mipLevels = mipLevels;
+
+			if (vkCreateImage(vkDevice, &createInfoImage, nullptr, &image) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create image!");
+			}
+		}
+
+		static void CreateImage
+		(
+			VkDevice vkDevice,
+			VkPhysicalDevice vkPhysicalDevice,
+			uint32_t texWidth,
+			uint32_t texHeight,
+			uint32_t mipLevels,
+			VkSampleCountFlagBits numSamples,
+			VkFormat format,
+			VkImageTiling tiling,
+			VkImageUsageFlags usage,
+			MemoryUsage memoryUsage,
+			VkImage& image,
+			VkDeviceMemory& imageMemory,
+			MemoryCategory category
+		)
+		{
+			CreateUnboundImage(vkDevice, texWidth, texHeight, mipLevels, numSamples, format, tiling, usage, image);
+
+			VkMemoryRequirements memoryRequirements;
+			vkGetImageMemoryRequirements(vkDevice, image, &memoryRequirements);
+
+			uint32_t memoryTypeIndex = Memory::FindMemoryType(vkPhysicalDevice, memoryRequirements.memoryTypeBits, memoryUsage, memoryRequirements.size);
+			if (Memory::AllocateMemory(vkDevice, memoryRequirements, memoryTypeIndex, category, imageMemory) != VK_SUCCESS)
+			{
+				vkDestroyImage(vkDevice, image, nullptr);
+				throw std::runtime_error("Failed to alloc image memory!");
+			}
+
+			vkBindImageMemory(vkDevice, image, imageMemory, 0);
+		}
+
+		static VkImageView CreateImageView(VkDevice vkDevice, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
+		{
+			VkImageViewCreateInfo imageViewCreateInfo{};
+			imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			imageViewCreateInfo.image = image;
+			imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			imageViewCreateInfo.format = format;
+			imageViewCreateInfo.subresourceRange.aspectMask = aspectFlags;
+			imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+			imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+			imageViewCreateInfo.subresourceRange.layerCount = 1;
+			imageViewCreateInfo.subresourceRange.levelCount = mipLevels;
+
+			VkImageView imageView;
+			if (vkCreateImageView(vkDevice, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to create texture image view!");
+			}
+
+			return imageView;
+		}
+
+		static VkCommandBuffer BeginOneTimeCommands(VkDevice vkDevice, VkCommandPool commandPool)
+		{
+			VkCommandBufferAllocateInfo allocInfoCommandBuffer{};
+			allocInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfoCommandBuffer.commandPool = commandPool;
+			allocInfoCommandBuffer.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; // primary can be submitted but not called from other buffers, secondary cannot be submitted but can be called from others
+			allocInfoCommandBuffer.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			if (vkAllocateCommandBuffers(vkDevice, &allocInfoCommandBuffer, &commandBuffer) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to allocate command buffers transient!");
+			}
+
+			VkCommandBufferBeginInfo beginInfoCommandBuffer{};
+			beginInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfoCommandBuffer.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+			vkBeginCommandBuffer(commandBuffer, &beginInfoCommandBuffer);
+
+			return commandBuffer;
+		}
+
+		static void EndOneTimeCommands(VkDevice vkDevice, VkQueue graphicsQueue, VkCommandPool commandPool, VkCommandBuffer commandBuffer)
+		{
+			vkEndCommandBuffer(commandBuffer);
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &commandBuffer;
+
+			vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+			/*
+			* two possible ways to wait on this transfer to complete. We could use a fence and wait with vkWaitForFences,
+			*	or simply wait for the transfer queue to become idle with vkQueueWaitIdle. A fence would allow you to schedule
+			*	multiple transfers simultaneously and wait for all of them complete, instead of executing one at a time.
+			*	That may give the driver more opportunities to optimize.
+			*/
+			vkQueueWaitIdle(graphicsQueue);
+			vkFreeCommandBuffers(vkDevice, commandPool, 1, &commandBuffer);
+		}
+
+		static void CopyBuffer(VkDevice vkDevice, VkQueue graphicsQueue, VkCommandPool commandPool, VkBuffer srcBuff, VkBuffer dstBuff, VkDeviceSize size)
+		{
+			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, commandPool);
+
+			// Do the copy
+			VkBufferCopy copyBufferRegion{};
+			copyBufferRegion.srcOffset = 0; // Optional
+			copyBufferRegion.dstOffset = 0; // Optional
+			copyBufferRegion.size = size;
+			vkCmdCopyBuffer(commandBuffer, srcBuff, dstBuff, 1, &copyBufferRegion);
+
+			EndOneTimeCommands(vkDevice, graphicsQueue, commandPool, commandBuffer);
+		}
+
+		/*
+		* Record the barrier for a layout transition into an existing command buffer, of mipLevels levels from baseMipLevel
+		*/
+		static void RecordLayoutTransition(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, uint32_t baseMipLevel = 0)
+		{
+			VkImageMemoryBarrier imageMemoryBarrier{};
+			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageMemoryBarrier.oldLayout = oldLayout;
+			imageMemoryBarrier.newLayout = newLayout;
+			imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageMemoryBarrier.image = image;
+
+			imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageMemoryBarrier.subresourceRange.baseMipLevel = baseMipLevel;
+			imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
+			imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+			imageMemoryBarrier.subresourceRange.layerCount = 1;
+
+			imageMemoryBarrier.srcAccessMask = 0; // TODO
+			imageMemoryBarrier.dstAccessMask = 0; // TODO
+
+			VkPipelineStageFlags srcStage;
+			VkPipelineStageFlags dstStage;
+
+			if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+			{
+				imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+				if (FormatHasStencilComponent(format))
+				{
+					imageMemoryBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+				}
+			}
+
+			if(oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+			{
+				imageMemoryBarrier.srcAccessMask = 0;
+				imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+				srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+				dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			}
+			else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+			{
+				imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+				srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+				dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			}
+			else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+			{
+				imageMemoryBarrier.srcAccessMask = 0;
+				imageMemoryBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+				srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+				dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+			}
+			else
+			{
+				throw std::invalid_argument("Unsupported layout transition!");
+			}
+
+			vkCmdPipelineBarrier
+			(
+				commandBuffer,
+				srcStage, dstStage,
+				0,
+				0, nullptr,
+				0, nullptr,
+				1, &imageMemoryBarrier
+			);
+		}
+
+		static void TransitionImageLayout(VkDevice vkDevice, VkQueue graphicsQueue, VkCommandPool commandPool, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
+		{
+			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, commandPool);
+
+			RecordLayoutTransition(commandBuffer, image, format, oldLayout, newLayout, mipLevels);
+
+			EndOneTimeCommands(vkDevice, graphicsQueue, commandPool, commandBuffer);
+		}
+
+		static void CopyBufferToImage(VkDevice vkDevice, VkQueue graphicsQueue, VkCommandPool commandPool, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+		{
+			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, commandPool);
+
+			VkBufferImageCopy bufferImageCopyRegion{};
+			bufferImageCopyRegion.bufferOffset = 0;
+			bufferImageCopyRegion.bufferRowLength = 0;
+			bufferImageCopyRegion.bufferImageHeight = 0;
+
+			bufferImageCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			bufferImageCopyRegion.imageSubresource.mipLevel = 0;
+			bufferImageCopyRegion.imageSubresource.baseArrayLayer = 0;
+			bufferImageCopyRegion.imageSubresource.layerCount = 1;
+
+			bufferImageCopyRegion.imageOffset = {0, 0, 0};
+			bufferImageCopyRegion.imageExtent = 
+			{
+				width,
+				height,
+				1
+			};
+
+			vkCmdCopyBufferToImage(
+				commandBuffer,
+				buffer,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				1,
+				&bufferImageCopyRegion
+			);
+
+			EndOneTimeCommands(vkDevice, graphicsQueue, commandPool, commandBuffer);
+		}
+
+		/*
+		* Upload several subresources, e.g. a pre-built mip chain, from one buffer in a single copy command
+		*/
+		static void CopyBufferToImage(VkDevice vkDevice, VkQueue graphicsQueue, VkCommandPool commandPool, VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& regions)
+		{
+			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, commandPool);
+
+			vkCmdCopyBufferToImage(
+				commandBuffer,
+				buffer,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(regions.size()),
+				regions.data()
+			);
+
+			EndOneTimeCommands(vkDevice, graphicsQueue, commandPool, commandBuffer);
+		}
+
+		/*
+		* It is uncommon in practice to generate the mipmap levels at runtime.
+		* Usually they are pregenerated and stored in the texture file alongside the base level to improve 
+		*	loading speed, see TextureBaker and the .vtex container. This remains the fallback for unbaked textures
+		*/
+		static void GenerateMipmaps
+		(
+			VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkQueue graphicsQueue, VkCommandPool commandPool,
+			VkImage image, VkFormat imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels
+		)
+		{
+			// Check if image format supports linear blitting
+			VkFormatProperties formatProperties;
+			vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice, imageFormat, &formatProperties);
+
+			// image created with optimal tiling format, so we check against "optimalTilingFeatures"
+			if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+			{
+				throw std::runtime_error("texture image format does not support linear blitting!");
+			}
+
+			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, commandPool);
+
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.image = image;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+			barrier.subresourceRange.levelCount = 1;
+
+			int32_t mipWidth = texWidth;
+			int32_t mipHeight = texHeight;
+
+			for (uint32_t i = 1; i < mipLevels; i++)
+			{
+				barrier.subresourceRange.baseMipLevel = i - 1;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+				vkCmdPipelineBarrier
+				(
+					commandBuffer,
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+					0, nullptr,
+					0, nullptr,
+					1, &barrier
+				);
+
+				VkImageBlit blit{};
+				blit.srcOffsets[0] = { 0, 0, 0 };
+				blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+				blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				blit.srcSubresource.mipLevel = i - 1;
+				blit.srcSubresource.baseArrayLayer = 0;
+				blit.srcSubresource.layerCount = 1;
+				blit.dstOffsets[0] = { 0, 0, 0 };
+				blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
+				blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				blit.dstSubresource.mipLevel = i;
+				blit.dstSubresource.baseArrayLayer = 0;
+				blit.dstSubresource.layerCount = 1;
+
+				vkCmdBlitImage
+				(
+					commandBuffer,
+					image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					1, &blit,
+					VK_FILTER_LINEAR
+				);
+
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+				vkCmdPipelineBarrier
+				(
+					commandBuffer,
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+					0, nullptr,
+					0, nullptr,
+					1, &barrier
+				);
+
+				if (mipWidth > 1) mipWidth /= 2;
+				if (mipHeight > 1) mipHeight /= 2;
+			}
+
+			barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier
+			(
+				commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+				0, nullptr,
+				0, nullptr,
+				1, &barrier
+			);
+
+			EndOneTimeCommands(vkDevice, graphicsQueue, commandPool, commandBuffer);
+		}
+	}
+}
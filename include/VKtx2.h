@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+#include <SDL.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VTextureContainer.h"
+
+namespace Vigor
+{
+	/*
+	* KTX 2.0 (Khronos texture container) header parsing.
+	*
+	* Only what can be copied to the GPU as is: a single 2D image, any VkFormat, no supercompression (Basis/Zstd).
+	*	The level index is translated into a TextureContainer::Header whose offsets are relative to the start of the file,
+	*	so the same upload path serves .ktx2 and .vtex.
+	*/
+	namespace Ktx2
+	{
+		constexpr uint8_t Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		struct Header
+		{
+			uint8_t identifier[12];
+			uint32_t vkFormat;
+			uint32_t typeSize;
+			uint32_t pixelWidth;
+			uint32_t pixelHeight;
+			uint32_t pixelDepth;
+			uint32_t layerCount;
+			uint32_t faceCount;
+			uint32_t levelCount;
+			uint32_t supercompressionScheme;
+
+			uint32_t dfdByteOffset;
+			uint32_t dfdByteLength;
+			uint32_t kvdByteOffset;
+			uint32_t kvdByteLength;
+			uint64_t sgdByteOffset;
+			uint64_t sgdByteLength;
+		};
+
+		struct LevelIndex
+		{
+			uint64_t byteOffset;
+			uint64_t byteLength;
+			uint64_t uncompressedByteLength;
+		};
+
+		static bool IsKtx2Path(const std::string& path)
+		{
+			std::string extension = std::filesystem::path(path).extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+			return extension == ".ktx2";
+		}
+
+		/*
+		* Validate fileData as an uploadable KTX2 and describe its levels, logs and returns false if it is not
+		*/
+		static bool Parse(const uint8_t* fileData, size_t fileSize, const std::string& path, TextureContainer::Header& outHeader)
+		{
+			Header header;
+			if (fileSize < sizeof(Header))
+			{
+				SDL_Log("%s is too small to be a KTX2 file", path.c_str());
+				return false;
+			}
+
+			memcpy(&header, fileData, sizeof(Header));
+
+			if (memcmp(header.identifier, Identifier, sizeof(Identifier)) != 0)
+			{
+				SDL_Log("%s is not a KTX2 file", path.c_str());
+				return false;
+			}
+
+			if (header.vkFormat == VK_FORMAT_UNDEFINED || header.supercompressionScheme != 0)
+			{
+				SDL_Log("%s is supercompressed (Basis/Zstd), transcoding is not supported", path.c_str());
+				return false;
+			}
+
+			if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1 || header.pixelHeight == 0)
+			{
+				SDL_Log("%s is not a single 2D image, arrays, cubemaps and volumes are not supported", path.c_str());
+				return false;
+			}
+
+			// a level count of 0 asks the loader to generate mips, upload the base level alone
+			uint32_t levelCount = std::max(header.levelCount, 1u);
+			if (levelCount > TextureContainer::MaxMipLevels || fileSize < sizeof(Header) + levelCount * sizeof(LevelIndex))
+			{
+				SDL_Log("%s has a malformed level index", path.c_str());
+				return false;
+			}
+
+			outHeader = {};
+			outHeader.magic = TextureContainer::Magic;
+			outHeader.version = TextureContainer::Version;
+			outHeader.format = header.vkFormat;
+			outHeader.width = header.pixelWidth;
+			outHeader.height = header.pixelHeight;
+			outHeader.mipLevels = levelCount;
+
+			for (uint32_t i = 0; i < levelCount; i++)
+			{
+				LevelIndex levelIndex;
+				memcpy(&levelIndex, fileData + sizeof(Header) + i * sizeof(LevelIndex), sizeof(LevelIndex));
+
+				if (levelIndex.byteLength == 0 || levelIndex.byteOffset + levelIndex.byteLength > fileSize)
+				{
+					SDL_Log("%s level %u lies outside the file", path.c_str(), i);
+					return false;
+				}
+
+				TextureContainer::MipLevel& level = outHeader.levels[i];
+				level.offset = levelIndex.byteOffset;
+				level.size = levelIndex.byteLength;
+				level.width = std::max(header.pixelWidth >> i, 1u);
+				level.height = std::max(header.pixelHeight >> i, 1u);
+			}
+
+			return true;
+		}
+	}
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VMemoryBudget.h"
+
+namespace Vigor
+{
+	/*
+	* How a resource's memory is accessed, picks where it is placed
+	*/
+	enum class MemoryUsage
+	{
+		GpuOnly, // written by transfers, read by the GPU: textures, vertex/index buffers
+		Upload, // written once by the CPU, copied by the GPU: staging buffers
+		Dynamic, // rewritten by the CPU as the GPU reads it: uniforms, descriptor buffers
+		Readback, // read by the CPU after writing: readback, staging that is decoded in place
+		TransientAttachment // only lives inside a render pass: MSAA color, depth
+	};
+
+	namespace Memory
+	{
+		/*
+		* One memory type to try, in preference order. Every list ends on something the spec guarantees exists
+		*/
+		struct MemoryPlacement
+		{
+			VkMemoryPropertyFlags required;
+			VkMemoryPropertyFlags avoided;
+			bool bBudgetChecked; // only while the heap has room, small BAR heaps fill quickly
+		};
+
+		/*
+		* Properties cached at device init, queried here only if the budget has not been initialized yet
+		*/
+		static VkPhysicalDeviceMemoryProperties GetMemoryProperties(VkPhysicalDevice vkPhysicalDevice)
+		{
+			/*
+			* The VkPhysicalDeviceMemoryProperties structure has two arrays memoryTypes and memoryHeaps.
+			* Memory heaps are distinct memory resources like dedicated VRAM and swap space in RAM for when
+			*		VRAM runs out
+			*/
+			VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties = Budget().GetMemoryProperties();
+			if (physicalDeviceMemoryProperties.memoryTypeCount == 0)
+			{
+				vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice, &physicalDeviceMemoryProperties);
+			}
+
+			return physicalDeviceMemoryProperties;
+		}
+
+		/*
+		* First type allowed by typeFilter that has every flag in memoryPropertyFlags
+		*/
+		static uint32_t FindMemoryType(VkPhysicalDevice vkPhysicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags memoryPropertyFlags)
+		{
+			VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties = GetMemoryProperties(vkPhysicalDevice);
+
+			for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; i++)
+			{
+				if (
+					(typeFilter & (1 << i)) && // check available memory type idx against filter
+					(physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & memoryPropertyFlags) == memoryPropertyFlags)
+				{
+					return i;
+				}
+			}
+
+			throw std::runtime_error("Failed to find suitable memory type!");
+		}
+
+		/*
+		* Best type for an allocation of size bytes accessed as memoryUsage.
+		*	Dynamic data goes to DEVICE_LOCAL | HOST_VISIBLE (ReBAR, or the 256 MiB BAR window) while it has room, so the GPU
+		*	reads it from VRAM and the CPU writes straight over the bus. Readback prefers HOST_CACHED, which may not be coherent,
+		*	whoever maps it flushes/invalidates. Everything written by the CPU otherwise stays HOST_COHERENT.
+		*	Transient attachments take LAZILY_ALLOCATED memory where it exists, the image must have TRANSIENT_ATTACHMENT usage
+		*/
+		static uint32_t FindMemoryType(VkPhysicalDevice vkPhysicalDevice, uint32_t typeFilter, MemoryUsage memoryUsage, VkDeviceSize size)
+		{
+			constexpr VkMemoryPropertyFlags hostCoherent = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+			std::vector<MemoryPlacement> placements;
+			switch (memoryUsage)
+			{
+			case MemoryUsage::GpuOnly:
+				placements = { { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, false }, { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, false }, { 0, 0, false } };
+				break;
+			case MemoryUsage::Upload:
+				placements = { { hostCoherent, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false }, { hostCoherent, 0, false } };
+				break;
+			case MemoryUsage::Dynamic:
+				placements = { { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | hostCoherent, 0, true }, { hostCoherent, 0, false } };
+				break;
+			case MemoryUsage::Readback:
+				placements = { { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 0, false }, { hostCoherent, 0, false } };
+				break;
+			case MemoryUsage::TransientAttachment:
+				// tilers keep these on chip and only back the pages they spill, desktop GPUs have no such type
+				placements = { { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, 0, false }, { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, false }, { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, false } };
+				break;
+			}
+
+			VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties = GetMemoryProperties(vkPhysicalDevice);
+
+			for (const MemoryPlacement& placement : placements)
+			{
+				for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; i++)
+				{
+					const VkMemoryType& memoryType = physicalDeviceMemoryProperties.memoryTypes[i];
+					if (!(typeFilter & (1 << i)) ||
+						(memoryType.propertyFlags & placement.required) != placement.required ||
+						(memoryType.propertyFlags & placement.avoided) != 0)
+					{
+						continue;
+					}
+
+					if (placement.bBudgetChecked && !Budget().Fits(memoryType.heapIndex, size, 0, MemoryBudget::TargetFraction))
+					{
+						continue;
+					}
+
+					return i;
+				}
+			}
+
+			throw std::runtime_error("Failed to find suitable memory type!");
+		}
+
+		/*
+		* vkAllocateMemory recorded against the memory budget under category, pNext is chained into the allocate info
+		*/
+		static VkResult AllocateMemory
+		(
+			VkDevice vkDevice,
+			const VkMemoryRequirements& memoryRequirements,
+			uint32_t memoryTypeIndex,
+			MemoryCategory category,
+			VkDeviceMemory& memory,
+			const void* pNext = nullptr
+		)
+		{
+			VkMemoryAllocateInfo memoryAllocateInfo{};
+			memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			memoryAllocateInfo.pNext = pNext;
+			memoryAllocateInfo.allocationSize = memoryRequirements.size;
+			memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+			VkResult allocateMemoryRes = vkAllocateMemory(vkDevice, &memoryAllocateInfo, nullptr, &memory);
+			if (allocateMemoryRes == VK_SUCCESS)
+			{
+				Budget().Track(memory, memoryAllocateInfo.memoryTypeIndex, memoryAllocateInfo.allocationSize, category);
+			}
+
+			return allocateMemoryRes;
+		}
+
+		static void FreeMemory(VkDevice vkDevice, VkDeviceMemory memory)
+		{
+			if (memory == VK_NULL_HANDLE)
+			{
+				return;
+			}
+
+			Budget().Untrack(memory);
+			vkFreeMemory(vkDevice, memory, nullptr);
+		}
+
+		static void CreateBuffer
+		(
+			VkDevice vkDevice,
+			VkPhysicalDevice vkPhysicalDevice,
+			VkDeviceSize size,
+			VkBufferUsageFlags usage,
+			MemoryUsage memoryUsage,
+			VkBuffer& buffer,
+			VkDeviceMemory& bufferMemory,
+			MemoryCategory category,
+			VkMemoryAllocateFlags allocateFlags = 0 // e.g. VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT for vkGetBufferDeviceAddress
+		)
+		{
+			VkBufferCreateInfo createInfoBuffer{};
+			createInfoBuffer.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			createInfoBuffer.size = size;
+			createInfoBuffer.usage = usage;
+			createInfoBuffer.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			if (vkCreateBuffer(vkDevice, &createInfoBuffer, nullptr, &buffer) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to create vertex buffer!");
+			}
+
+			VkMemoryRequirements memoryRequirements;
+			vkGetBufferMemoryRequirements(vkDevice, buffer, &memoryRequirements);
+
+			VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo{};
+			memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+			memoryAllocateFlagsInfo.flags = allocateFlags;
+
+			uint32_t memoryTypeIndex = FindMemoryType(vkPhysicalDevice, memoryRequirements.memoryTypeBits, memoryUsage, memoryRequirements.size);
+			if (AllocateMemory(vkDevice, memoryRequirements, memoryTypeIndex, category, bufferMemory, allocateFlags != 0 ? &memoryAllocateFlagsInfo : nullptr) != VK_SUCCESS)
+			{
+				vkDestroyBuffer(vkDevice, buffer, nullptr);
+				throw std::runtime_error("Failed to allocate vertex buffer memory!");
+			}
+
+			vkBindBufferMemory(vkDevice, buffer, bufferMemory, 0); // bind allocated memory
+		}
+	}
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+#include <SDL.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+namespace Vigor
+{
+	/*
+	* What an allocation is for, usage is reported per category
+	*/
+	enum class MemoryCategory : uint8_t
+	{
+		Geometry, // vertex/index buffers
+		Texture,
+		Attachment, // color/depth targets
+		Staging, // upload buffers
+		Uniform,
+		Descriptor, // descriptor buffers
+		Count
+	};
+
+	/*
+	* Device memory in use per heap and per category, against what the device says this process may use.
+	*
+	* Every vkAllocateMemory goes through Memory::AllocateMemory, which records it here. With VK_EXT_memory_budget the budget and
+	*	the driver's view of our usage are queried once a frame, allocations made since are added on top. Without it the budget is
+	*	a fixed share of the heap and usage is what we have allocated. Allocation happens on the main thread only.
+	*/
+	class MemoryBudget
+	{
+	public:
+		static constexpr float TargetFraction = 0.90f; // streaming grows up to here
+		static constexpr float HighWaterFraction = 0.95f; // past here, shrink back to the target
+		static constexpr float FallbackBudgetFraction = 0.80f; // of the heap size, leaves room for the driver and other processes
+
+		MemoryBudget()
+			: vkPhysicalDevice(VK_NULL_HANDLE)
+			, bMemoryBudgetExtension(false)
+			, bOverHighWater(false)
+			, nonCoherentAtomSize(1)
+			, memoryProperties{}
+			, heaps{}
+		{
+
+		}
+
+		void Init(VkPhysicalDevice _vkPhysicalDevice, bool _bMemoryBudgetExtension)
+		{
+			vkPhysicalDevice = _vkPhysicalDevice;
+			bMemoryBudgetExtension = _bMemoryBudgetExtension;
+
+			vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice, &memoryProperties);
+
+			VkPhysicalDeviceProperties physicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(vkPhysicalDevice, &physicalDeviceProperties);
+			nonCoherentAtomSize = physicalDeviceProperties.limits.nonCoherentAtomSize;
+
+			Update();
+		}
+
+		/*
+		* Refresh the budget, once a frame
+		*/
+		void Update()
+		{
+			if (bMemoryBudgetExtension)
+			{
+				VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties{};
+				memoryBudgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+				VkPhysicalDeviceMemoryProperties2 memoryProperties2{};
+				memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+				memoryProperties2.pNext = &memoryBudgetProperties;
+
+				vkGetPhysicalDeviceMemoryProperties2(vkPhysicalDevice, &memoryProperties2);
+
+				for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+				{
+					heaps[i].budget = memoryBudgetProperties.heapBudget[i];
+					heaps[i].reportedUsage = memoryBudgetProperties.heapUsage[i];
+					heaps[i].trackedAtReport = heaps[i].tracked;
+				}
+			}
+			else
+			{
+				for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+				{
+					heaps[i].budget = static_cast<VkDeviceSize>(memoryProperties.memoryHeaps[i].size * FallbackBudgetFraction);
+					heaps[i].reportedUsage = 0;
+					heaps[i].trackedAtReport = 0;
+				}
+			}
+
+			uint32_t deviceLocalHeap = GetDeviceLocalHeap();
+			bool bOver = !Fits(deviceLocalHeap, 0, 0, HighWaterFraction);
+			if (bOver && !bOverHighWater)
+			{
+				SDL_Log("Device local memory is over %.0f%% of its budget", HighWaterFraction * 100.0f);
+				LogReport();
+			}
+			bOverHighWater = bOver;
+		}
+
+		void Track(VkDeviceMemory memory, uint32_t memoryTypeIndex, VkDeviceSize size, MemoryCategory category)
+		{
+			uint32_t heapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+
+			// lazily allocated memory is only backed as the GPU spills into it, vkGetDeviceMemoryCommitment says how much
+			if (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+			{
+				size = 0;
+			}
+
+			allocations[memory] = { size, memoryTypeIndex, heapIndex, category };
+			heaps[heapIndex].tracked += size;
+			categoryBytes[static_cast<size_t>(category)] += size;
+		}
+
+		void Untrack(VkDeviceMemory memory)
+		{
+			auto itAllocation = allocations.find(memory);
+			if (itAllocation == allocations.end())
+			{
+				return;
+			}
+
+			const Allocation& allocation = itAllocation->second;
+			heaps[allocation.heapIndex].tracked -= allocation.size;
+			categoryBytes[static_cast<size_t>(allocation.category)] -= allocation.size;
+
+			allocations.erase(itAllocation);
+		}
+
+		/*
+		* Usage as the driver last reported it plus whatever we have allocated (or freed) since
+		*/
+		VkDeviceSize GetUsage(uint32_t heapIndex) const
+		{
+			const Heap& heap = heaps[heapIndex];
+			return heap.reportedUsage + heap.tracked - std::min(heap.trackedAtReport, heap.reportedUsage + heap.tracked);
+		}
+
+		VkDeviceSize GetBudget(uint32_t heapIndex) const
+		{
+			return heaps[heapIndex].budget;
+		}
+
+		VkDeviceSize GetCategoryBytes(MemoryCategory category) const
+		{
+			return categoryBytes[static_cast<size_t>(category)];
+		}
+
+		/*
+		* Cached at Init, memoryTypeCount is 0 before then
+		*/
+		const VkPhysicalDeviceMemoryProperties& GetMemoryProperties() const
+		{
+			return memoryProperties;
+		}
+
+		VkDeviceSize GetNonCoherentAtomSize() const
+		{
+			return nonCoherentAtomSize;
+		}
+
+		/*
+		* Flags of the type memory was allocated from, 0 if it was not allocated through Memory::AllocateMemory
+		*/
+		VkMemoryPropertyFlags GetPropertyFlags(VkDeviceMemory memory) const
+		{
+			auto itAllocation = allocations.find(memory);
+			if (itAllocation == allocations.end())
+			{
+				return 0;
+			}
+
+			return memoryProperties.memoryTypes[itAllocation->second.memoryTypeIndex].propertyFlags;
+		}
+
+		/*
+		* Would bytes more fit under fraction of the budget, counting pendingFree as already gone
+		*/
+		bool Fits(uint32_t heapIndex, VkDeviceSize bytes, VkDeviceSize pendingFree, float fraction) const
+		{
+			VkDeviceSize usage = GetUsage(heapIndex);
+			usage -= std::min(usage, pendingFree);
+
+			return usage + bytes <= static_cast<VkDeviceSize>(GetBudget(heapIndex) * fraction);
+		}
+
+		/*
+		* Largest DEVICE_LOCAL heap, where textures and attachments live
+		*/
+		uint32_t GetDeviceLocalHeap() const
+		{
+			uint32_t deviceLocalHeap = 0;
+			VkDeviceSize deviceLocalSize = 0;
+			for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+			{
+				const VkMemoryHeap& heap = memoryProperties.memoryHeaps[i];
+				if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && heap.size > deviceLocalSize)
+				{
+					deviceLocalHeap = i;
+					deviceLocalSize = heap.size;
+				}
+			}
+
+			return deviceLocalHeap;
+		}
+
+		void LogReport() const
+		{
+			static const char* categoryNames[] = { "geometry", "textures", "attachments", "staging", "uniforms", "descriptors" };
+
+			for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+			{
+				SDL_Log("Heap %u: %.1f / %.1f MiB%s", i, GetUsage(i) / (1024.0 * 1024.0), GetBudget(i) / (1024.0 * 1024.0), bMemoryBudgetExtension ? "" : " (estimated budget)");
+			}
+
+			for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); i++)
+			{
+				SDL_Log("  %s: %.1f MiB", categoryNames[i], categoryBytes[i] / (1024.0 * 1024.0));
+			}
+		}
+
+	private:
+		struct Allocation
+		{
+			VkDeviceSize size;
+			uint32_t memoryTypeIndex;
+			uint32_t heapIndex;
+			MemoryCategory category;
+		};
+
+		struct Heap
+		{
+			VkDeviceSize budget = 0;
+			VkDeviceSize reportedUsage = 0; // from VK_EXT_memory_budget, includes allocations we do not track
+			VkDeviceSize tracked = 0;
+			VkDeviceSize trackedAtReport = 0;
+		};
+
+		VkPhysicalDevice vkPhysicalDevice;
+		bool bMemoryBudgetExtension;
+		bool bOverHighWater;
+
+		VkDeviceSize nonCoherentAtomSize;
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		std::array<Heap, VK_MAX_MEMORY_HEAPS> heaps;
+		std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)> categoryBytes{};
+
+		std::unordered_map<VkDeviceMemory, Allocation> allocations;
+	};
+
+	namespace Memory
+	{
+		/*
+		* The one budget every allocation is recorded in, inline so every translation unit shares it
+		*/
+		inline MemoryBudget& Budget()
+		{
+			static MemoryBudget memoryBudget;
+			return memoryBudget;
+		}
+	}
+}
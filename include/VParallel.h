@@ -0,0 +1,197 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+namespace Vigor
+{
+	namespace Parallel
+	{
+		/*
+		* Threads kept alive for ForEachBand, one per hardware thread beside the caller. Spawning and joining per call cost
+		*	about as much as the copies it was meant to speed up
+		*/
+		class WorkerPool
+		{
+		public:
+			WorkerPool()
+				: bStopping(false)
+			{
+				size_t workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1;
+				workers.reserve(workerCount);
+				for (size_t i = 0; i < workerCount; i++)
+				{
+					workers.emplace_back(&WorkerPool::WorkerLoop, this);
+				}
+			}
+
+			~WorkerPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(jobsMutex);
+					bStopping = true;
+				}
+				jobsCondition.notify_all();
+
+				for (std::thread& worker : workers)
+				{
+					worker.join();
+				}
+			}
+
+			WorkerPool(const WorkerPool&) = delete;
+			WorkerPool& operator=(const WorkerPool&) = delete;
+
+			size_t GetWorkerCount() const
+			{
+				return workers.size();
+			}
+
+			/*
+			* Queue [begin, end) ranges on the workers, run firstBand on the calling thread and return once all have finished
+			*/
+			void Run(const std::vector<std::pair<size_t, size_t>>& bands, std::pair<size_t, size_t> firstBand, const std::function<void(size_t begin, size_t end)>& bandFunction)
+			{
+				Batch batch{ bands.size() };
+				{
+					std::lock_guard<std::mutex> lock(jobsMutex);
+					for (const auto& [begin, end] : bands)
+					{
+						jobs.push_back({ &bandFunction, begin, end, &batch });
+					}
+				}
+				jobsCondition.notify_all();
+
+				bandFunction(firstBand.first, firstBand.second);
+
+				std::unique_lock<std::mutex> lock(jobsMutex);
+				doneCondition.wait(lock, [&batch]() { return batch.remaining == 0; });
+			}
+
+		private:
+			struct Batch
+			{
+				size_t remaining; // guarded by jobsMutex
+			};
+
+			struct BandJob
+			{
+				const std::function<void(size_t, size_t)>* bandFunction;
+				size_t begin;
+				size_t end;
+				Batch* batch;
+			};
+
+			void WorkerLoop()
+			{
+				while (true)
+				{
+					BandJob job;
+					{
+						std::unique_lock<std::mutex> lock(jobsMutex);
+						jobsCondition.wait(lock, [this]() { return bStopping || !jobs.empty(); });
+
+						if (bStopping)
+						{
+							return;
+						}
+
+						job = jobs.front();
+						jobs.pop_front();
+					}
+
+					(*job.bandFunction)(job.begin, job.end);
+
+					{
+						std::lock_guard<std::mutex> lock(jobsMutex);
+						job.batch->remaining--;
+					}
+					doneCondition.notify_all();
+				}
+			}
+
+		private:
+			std::vector<std::thread> workers;
+
+			std::mutex jobsMutex;
+			std::condition_variable jobsCondition;
+			std::condition_variable doneCondition;
+			std::deque<BandJob> jobs;
+			bool bStopping;
+		};
+
+		/*
+		* Started on first use and joined at exit
+		*/
+		static WorkerPool& Workers()
+		{
+			static WorkerPool workerPool;
+			return workerPool;
+		}
+
+		/*
+		* Split [0, count) into contiguous bands of at least minBandSize and run them across the worker pool,
+		*	the calling thread takes the first band. Small ranges run inline without touching the pool
+		*/
+		static void ForEachBand(size_t count, size_t minBandSize, const std::function<void(size_t begin, size_t end)>& bandFunction)
+		{
+			size_t bandCount = count / std::max<size_t>(minBandSize, 1);
+			if (bandCount <= 1)
+			{
+				bandFunction(0, count);
+				return;
+			}
+
+			WorkerPool& workerPool = Workers();
+			bandCount = std::min(bandCount, workerPool.GetWorkerCount() + 1);
+			if (bandCount == 1)
+			{
+				bandFunction(0, count);
+				return;
+			}
+
+			size_t bandSize = (count + bandCount - 1) / bandCount;
+
+			std::vector<std::pair<size_t, size_t>> bands;
+			bands.reserve(bandCount - 1);
+			for (size_t band = 1; band < bandCount; band++)
+			{
+				size_t begin = band * bandSize;
+				size_t end = std::min(begin + bandSize, count);
+				if (begin < end)
+				{
+					bands.emplace_back(begin, end);
+				}
+			}
+
+			workerPool.Run(bands, { 0, std::min(bandSize, count) }, bandFunction);
+		}
+
+		/*
+		* memcpy split into bands, worth it once a copy is large enough to be limited by one core rather than memory bandwidth.
+		*	Anything under two bands is a single memcpy on the calling thread
+		*/
+		static void Copy(void* destination, const void* source, size_t size)
+		{
+			constexpr size_t minBandBytes = 4 * 1024 * 1024;
+
+			if (size < minBandBytes * 2)
+			{
+				memcpy(destination, source, size);
+				return;
+			}
+
+			ForEachBand(size, minBandBytes, [destination, source](size_t begin, size_t end)
+				{
+					memcpy(static_cast<char*>(destination) + begin, static_cast<const char*>(source) + begin, end - begin);
+				});
+		}
+	}
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <SDL.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VErrors.h"
+#include "VFilesystem.h"
+
+namespace Vigor
+{
+	/*
+	* Engine owned VkPipelineCache persisted between runs.
+	*
+	* Every window creates its pipelines through the same cache so they all feed and benefit from it,
+	*	on shutdown the merged result is written back to disk.
+	*/
+	class PipelineCache
+	{
+	public:
+		PipelineCache()
+			: vkPipelineCache(VK_NULL_HANDLE)
+			, bLoadedFromDisk(false)
+		{
+
+		}
+
+		/*
+		* Create the cache, seeded with the on-disk data if it was written by this exact device and driver
+		*/
+		void Init(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, const std::string& _cachePath)
+		{
+			cachePath = _cachePath;
+
+			std::vector<char> cacheData;
+			if (Filesystem::TryRead(cachePath, cacheData))
+			{
+				if (IsCacheDataValid(vkPhysicalDevice, cacheData))
+				{
+					bLoadedFromDisk = true;
+				}
+				else
+				{
+					SDL_Log("Pipeline cache at %s is stale or corrupt, starting cold", cachePath.c_str());
+					cacheData.clear();
+				}
+			}
+
+			VkPipelineCacheCreateInfo createInfoPipelineCache{};
+			createInfoPipelineCache.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+			createInfoPipelineCache.initialDataSize = cacheData.size();
+			createInfoPipelineCache.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+			VkResult createPipelineCacheRes = vkCreatePipelineCache(vkDevice, &createInfoPipelineCache, nullptr, &vkPipelineCache);
+			if (createPipelineCacheRes != VK_SUCCESS)
+			{
+				Vigor::Errors::RaiseRuntimeError("Failed to create pipeline cache Error: {}\n\n", (int)createPipelineCacheRes);
+			}
+		}
+
+		/*
+		* Write the cache contents to disk, the old file is only replaced once the new one is complete
+		*/
+		void Save(VkDevice vkDevice) const
+		{
+			size_t dataSize = 0;
+			if (vkGetPipelineCacheData(vkDevice, vkPipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+			{
+				return;
+			}
+
+			std::vector<char> cacheData(dataSize);
+			if (vkGetPipelineCacheData(vkDevice, vkPipelineCache, &dataSize, cacheData.data()) != VK_SUCCESS)
+			{
+				SDL_Log("Failed to read back pipeline cache data");
+				return;
+			}
+
+			if (!Filesystem::WriteAtomic(cachePath, cacheData.data(), dataSize))
+			{
+				SDL_Log("Failed to write pipeline cache to %s", cachePath.c_str());
+			}
+		}
+
+		void Shutdown(VkDevice vkDevice)
+		{
+			Save(vkDevice);
+
+			vkDestroyPipelineCache(vkDevice, vkPipelineCache, nullptr);
+			vkPipelineCache = VK_NULL_HANDLE;
+		}
+
+		VkPipelineCache Get() const
+		{
+			return vkPipelineCache;
+		}
+
+		bool IsWarm() const
+		{
+			return bLoadedFromDisk;
+		}
+
+	private:
+		/*
+		* Drivers reject or, worse, misbehave on data from another device/driver, so check the header ourselves
+		*/
+		static bool IsCacheDataValid(VkPhysicalDevice vkPhysicalDevice, const std::vector<char>& cacheData)
+		{
+			if (cacheData.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+			{
+				return false;
+			}
+
+			VkPipelineCacheHeaderVersionOne header;
+			memcpy(&header, cacheData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+			VkPhysicalDeviceProperties physicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(vkPhysicalDevice, &physicalDeviceProperties);
+
+			return
+				header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+				header.headerSize <= cacheData.size() &&
+				header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+				header.vendorID == physicalDeviceProperties.vendorID &&
+				header.deviceID == physicalDeviceProperties.deviceID &&
+				memcmp(header.pipelineCacheUUID, physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+		}
+
+	private:
+		VkPipelineCache vkPipelineCache;
+		std::string cachePath;
+		bool bLoadedFromDisk;
+	};
+}
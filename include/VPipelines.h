@@ -0,0 +1,1396 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include <SDL.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VShaders.h"
+#include "VFilesystem.h"
+#include "VShaderCompiler.h"
+#include "VEmbeddedShaders.h"
+#include "VEngineTypes.h"
+#include "VDescriptors.h"
+#include "VPipelineCache.h"
+#include "VImages.h"
+
+namespace Vigor
+{
+	/*
+	* Fragment shader features, baked into each pipeline as specialization constants so the driver strips
+	*	whatever a variant doesn't use instead of branching at runtime. Ids match shaders/glsl/fragment/shader.frag
+	*/
+	namespace ShaderFeatures
+	{
+		constexpr uint32_t VertexColor = 1 << 0; // constant_id 0 - modulate by the interpolated vertex color
+		constexpr uint32_t Textured = 1 << 1; // constant_id 1 - sample the material's texture from the bindless table
+		constexpr uint32_t AlphaTest = 1 << 2; // constant_id 2 - discard fragments below the alpha cutoff
+
+		constexpr uint32_t Count = 3;
+	}
+
+	/*
+	* Everything that varies between the graphics pipelines a window builds
+	*/
+	struct GraphicsPipelineDesc
+	{
+		VkShaderModule vertexShaderModule = VK_NULL_HANDLE;
+		VkShaderModule fragmentShaderModule = VK_NULL_HANDLE;
+
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkRenderPass renderPass = VK_NULL_HANDLE; // VK_NULL_HANDLE - dynamic rendering against the formats below
+
+		VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+		VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+		VkSampleCountFlagBits rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+		bool bSampleShading = true;
+		bool bBlendEnable = false; // standard alpha blending
+
+		uint32_t shaderFeatures = ShaderFeatures::Textured; // ShaderFeatures bits
+
+		VkPipelineCreateFlags flags = 0; // e.g. required by the descriptor backend
+	};
+
+	namespace Pipelines
+	{
+		/*
+		* Single subpass MSAA color + depth pass resolving into a presentable image.
+		*	Pipelines built against one are usable with any other created from the same formats and sample count
+		*/
+		static VkResult CreateRenderPass(VkDevice vkDevice, VkFormat colorFormat, VkFormat depthFormat, VkSampleCountFlagBits numSamples, VkRenderPass& outRenderPass)
+		{
+			// COLOR
+			VkAttachmentDescription colorAttachment{};
+			colorAttachment.format = colorFormat;
+			colorAttachment.samples = numSamples;
+			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // only the resolve is presented, the samples never leave the pass
+			colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // not doing anything with stencil yet so dont care
+			colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // not doing anything with stencil yet so dont care
+			colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+			// Sub-passes and attachment refs
+			VkAttachmentReference colorAttachmentRef{};
+			colorAttachmentRef.attachment = 0; // specifies which attachment to reference by its index
+			colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+			// this exists as we cannot present multisampled images so we must "resolve" the image first
+			VkAttachmentDescription colorAttachmentResolve{};
+			colorAttachmentResolve.format = colorFormat;
+			colorAttachmentResolve.samples = VK_SAMPLE_COUNT_1_BIT;
+			colorAttachmentResolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+			VkAttachmentReference colorAttachmentResolveRef{};
+			colorAttachmentResolveRef.attachment = 2;
+			colorAttachmentResolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+			// DEPTH
+			VkAttachmentDescription depthAttachment{};
+			depthAttachment.format = depthFormat;
+			depthAttachment.samples = numSamples;
+			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+			VkAttachmentReference depthAttachmentRef{};
+			depthAttachmentRef.attachment = 1;
+			depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+			VkSubpassDescription subpass{};
+			subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // supports compute subpasses so need to be explicit
+			subpass.colorAttachmentCount = 1;
+			subpass.pColorAttachments = &colorAttachmentRef;
+			subpass.pDepthStencilAttachment = &depthAttachmentRef;
+			subpass.pResolveAttachments = &colorAttachmentResolveRef;
+
+			/* -- NOTE --
+			* The index of the attachment in this array is directly referenced from the fragment shader with "layout(location = 0) out vec4 outColor" in OpenGL
+			*
+			* The following other types of attachments can be referenced by a subpass:
+			*   - pInputAttachments: Attachments that are read from a shader
+			*   - pResolveAttachments: Attachments used for multisampling color attachments
+			*   - pDepthStencilAttachment: Attachment for depth and stencil data
+			*   - pPreserveAttachments: Attachments that are not used by this subpass, but for which the data must be preserved
+			*/
+
+			VkSubpassDependency subpassDependency{};
+			// dependant subpass and dependency
+			subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+			subpassDependency.dstSubpass = 0;
+			// what do we wait on
+			// the previous pass's attachment writes, possibly another window's or frame's on the same pooled memory
+			subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			subpassDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			// wait on color attachment stage and the writing of this, dont transition until allowed + necessary
+			subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+			subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+			std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
+			VkRenderPassCreateInfo createInfoRenderPass{};
+			createInfoRenderPass.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+			createInfoRenderPass.attachmentCount = static_cast<uint32_t>(attachments.size());
+			createInfoRenderPass.pAttachments = attachments.data();
+			createInfoRenderPass.subpassCount = 1;
+			createInfoRenderPass.pSubpasses = &subpass;
+			// use subpass depenency
+			createInfoRenderPass.dependencyCount = 1;
+			createInfoRenderPass.pDependencies = &subpassDependency;
+
+			return vkCreateRenderPass(vkDevice, &createInfoRenderPass, nullptr, &outRenderPass);
+		}
+
+		/*
+		* Pipeline layout shared by every graphics pipeline: set 0 per frame uniforms, set 1 bindless textures
+		*	and the per draw material index push constant
+		*/
+		static VkResult CreatePipelineLayout(VkDevice vkDevice, VkDescriptorSetLayout frameSetLayout, VkDescriptorSetLayout textureSetLayout, VkPipelineLayout& outPipelineLayout)
+		{
+			std::array<VkDescriptorSetLayout, 2> setLayouts = { frameSetLayout, textureSetLayout };
+
+			// per draw material index used to select a texture from the bindless table
+			VkPushConstantRange drawPushConstantRange{};
+			drawPushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			drawPushConstantRange.offset = 0;
+			drawPushConstantRange.size = sizeof(DrawPushConstants);
+
+			VkPipelineLayoutCreateInfo createInfoPipelineLayout{};
+			createInfoPipelineLayout.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			createInfoPipelineLayout.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+			createInfoPipelineLayout.pSetLayouts = setLayouts.data();
+			createInfoPipelineLayout.pushConstantRangeCount = 1;
+			createInfoPipelineLayout.pPushConstantRanges = &drawPushConstantRange;
+
+			return vkCreatePipelineLayout(vkDevice, &createInfoPipelineLayout, nullptr, &outPipelineLayout);
+		}
+
+		/*
+		* Build a graphics pipeline from desc, safe to call from any thread as long as desc's handles stay alive.
+		*	With libraryParts set only that subset of state is built into a VK_EXT_graphics_pipeline_library library
+		*/
+		static VkResult CreateGraphicsPipeline(VkDevice vkDevice, VkPipelineCache vkPipelineCache, const GraphicsPipelineDesc& desc, VkPipeline& outPipeline, VkGraphicsPipelineLibraryFlagsEXT libraryParts = 0)
+		{
+			VkPipelineShaderStageCreateInfo createInfoVertexShaderStage{};
+			createInfoVertexShaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			createInfoVertexShaderStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+			createInfoVertexShaderStage.module = desc.vertexShaderModule;
+			createInfoVertexShaderStage.pName = "main";
+
+			VkPipelineShaderStageCreateInfo createInfoFragmentShaderStage{};
+			createInfoFragmentShaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			createInfoFragmentShaderStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			createInfoFragmentShaderStage.module = desc.fragmentShaderModule;
+			createInfoFragmentShaderStage.pName = "main";
+
+			// one VkBool32 per ShaderFeatures bit, constant_id i reads specializationData[i]
+			std::array<VkBool32, ShaderFeatures::Count> specializationData{};
+			std::array<VkSpecializationMapEntry, ShaderFeatures::Count> specializationMapEntries{};
+			for (uint32_t i = 0; i < ShaderFeatures::Count; i++)
+			{
+				specializationData[i] = (desc.shaderFeatures & (1u << i)) ? VK_TRUE : VK_FALSE;
+
+				specializationMapEntries[i].constantID = i;
+				specializationMapEntries[i].offset = i * sizeof(VkBool32);
+				specializationMapEntries[i].size = sizeof(VkBool32);
+			}
+
+			VkSpecializationInfo specializationInfo{};
+			specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationMapEntries.size());
+			specializationInfo.pMapEntries = specializationMapEntries.data();
+			specializationInfo.dataSize = sizeof(specializationData);
+			specializationInfo.pData = specializationData.data();
+
+			createInfoFragmentShaderStage.pSpecializationInfo = &specializationInfo;
+
+			VkPipelineShaderStageCreateInfo shaderStages[] = { createInfoVertexShaderStage, createInfoFragmentShaderStage };
+
+			// Dynamic State Setup
+			std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+			VkPipelineDynamicStateCreateInfo createInfoDynamicState{};
+			createInfoDynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+			createInfoDynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()); // TODO - remove cast if possible
+			createInfoDynamicState.pDynamicStates = dynamicStates.data();
+
+			// Get Vertex structure values
+			auto bindingDescription = Vertex::GetBindingDescription();
+			auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+
+			// Vertex Input
+			VkPipelineVertexInputStateCreateInfo createInfoVertexInput{};
+			createInfoVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+			createInfoVertexInput.vertexBindingDescriptionCount = 1;
+			createInfoVertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+			createInfoVertexInput.pVertexBindingDescriptions = &bindingDescription;
+			createInfoVertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+			// Input Assembly
+			VkPipelineInputAssemblyStateCreateInfo createInfoInputAssembly{};
+			createInfoInputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+			createInfoInputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			createInfoInputAssembly.primitiveRestartEnable = VK_FALSE; // if VK_TRUE, then it's possible to break up lines and triangles in the _STRIP topology modes by using a special index of 0xFFFF or 0xFFFFFFFF.
+
+			// Viewport and Scissor
+			/* -- NOTE --
+			* Viewport defines the region that pixels transformed from an image to the framebuffer
+			* Scissor defines the region of pixels that are stored, anything outside this within the viewport are discarded by the rasterizer
+			*/
+
+			/* -- NOTE --
+			* These can be setup as static as part of pipeline state but are supported as dynamic
+			* This generally doesnt have a noticeable perf hit and is worthwhile as commonly needed
+			*/
+
+			/* -- NOTE --
+			* With dynamic state it's even possible to specify different viewports and or scissor rectangles within a single command buffer.
+			*
+			* Without dynamic state, the viewport and scissor rectangle need to be set in the pipeline using the VkPipelineViewportStateCreateInfo struct.
+			* This makes the viewport and scissor rectangle for this pipeline immutable.
+			* Any changes required to these values would require a new pipeline to be created with the new values.
+			*
+			* Using multiple requires enabling a GPU feature (see logical device init).
+			*/
+
+			// Viewport Pipeline
+			VkPipelineViewportStateCreateInfo createInfoViewportState{};
+			createInfoViewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+			createInfoViewportState.viewportCount = 1;
+			createInfoViewportState.pViewports = nullptr; // dynamic, set at record time from the swap chain extent
+			createInfoViewportState.scissorCount = 1;
+			createInfoViewportState.pScissors = nullptr; // dynamic
+
+			// Rasterizer
+			VkPipelineRasterizationStateCreateInfo createInfoRasterizerState{};
+			createInfoRasterizerState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+			/*
+			* if VK_TRUE, then fragments that are beyond the near and far planes are clamped to them as opposed to discarding them.
+			* This is useful in some special cases like shadow maps.
+			* Using this requires enabling a GPU feature.
+			*/
+			createInfoRasterizerState.depthClampEnable = VK_FALSE;
+			createInfoRasterizerState.rasterizerDiscardEnable = VK_FALSE; // if VK_TRUE, then geometry never passes through the rasterizer stage. This disables any output to the framebuffer.
+			createInfoRasterizerState.polygonMode = VK_POLYGON_MODE_FILL; // Using any mode other than fill requires enabling a GPU feature.
+			createInfoRasterizerState.lineWidth = 1.0f; // describes the thickness of lines in number of fragments. The maximum line width depends on the hardware, any line thicker than 1.0f requires the "wideLines" GPU feature.
+			createInfoRasterizerState.cullMode = VK_CULL_MODE_BACK_BIT;
+			createInfoRasterizerState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			/*
+			* The rasterizer can alter the depth values by adding a constant value or biasing them based on a fragment's slope.
+			* This is sometimes used for shadow mapping, but we won't be using it so depthBiasEnable is set to VK_FALSE
+			*/
+			createInfoRasterizerState.depthBiasEnable = VK_FALSE;
+			createInfoRasterizerState.depthBiasConstantFactor = 0.0f; // Optional
+			createInfoRasterizerState.depthBiasClamp = 0.0f; // Optional
+			createInfoRasterizerState.depthBiasSlopeFactor = 0.0f; // Optional
+
+			// MSAA (Multisampling) - Disabled with this config
+			VkPipelineMultisampleStateCreateInfo createInfoMultisampling{};
+			createInfoMultisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+			createInfoMultisampling.sampleShadingEnable = VK_FALSE;
+			createInfoMultisampling.rasterizationSamples = desc.rasterizationSamples;
+			createInfoMultisampling.minSampleShading = 1.0f; // Optional
+			createInfoMultisampling.pSampleMask = nullptr; // Optional
+			createInfoMultisampling.alphaToCoverageEnable = VK_FALSE; // Optional
+			createInfoMultisampling.alphaToOneEnable = VK_FALSE; // Optional
+			createInfoMultisampling.sampleShadingEnable = desc.bSampleShading ? VK_TRUE : VK_FALSE; // sample shading smooths texture aliasing but is the more expensive variant
+			createInfoMultisampling.minSampleShading = .2f; // min fraction for sample shading; closer to one is smoother
+
+			/* Depth and Stencil testing
+			* To configure this VkPipelineDepthStencilStateCreateInfo must be used but is ignored for now
+			*/
+
+			// Color Blending - (At the moment the following config doesnt perform any color blending with the chosen settings)
+			/* -- NOTE --
+			* There are two types of structs to configure color blending.
+			* The first struct, VkPipelineColorBlendAttachmentState contains the configuration per attached framebuffer.
+			* The second struct, VkPipelineColorBlendStateCreateInfo contains the global color blending settings.
+			*
+			* ATM we only have one framebuffer, so we do the following:
+			*/
+
+			// Per frame buffer
+			VkPipelineColorBlendAttachmentState createInfoColorBlendAttachment{};
+			createInfoColorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+			// Blending Disabled:
+			createInfoColorBlendAttachment.blendEnable = VK_FALSE; // the new color from the fragment shader is passed through unmodified, otherwise the resulting color is AND'd with the colorWriteMask to determine which channels are actually passed through
+			createInfoColorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
+			createInfoColorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
+			createInfoColorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD; // Optional
+			createInfoColorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
+			createInfoColorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
+			createInfoColorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD; // Optional
+
+			// Alpha blending:
+			if (desc.bBlendEnable)
+			{
+				createInfoColorBlendAttachment.blendEnable = VK_TRUE;
+				createInfoColorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+				createInfoColorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+				createInfoColorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+				createInfoColorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+				createInfoColorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+				createInfoColorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+			}
+
+			// Global blend settings
+			VkPipelineColorBlendStateCreateInfo createInfoColorBlending{};
+			createInfoColorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+			createInfoColorBlending.logicOpEnable = VK_FALSE; // set to true to utilize bitwise blending, will act as if each attachment has blendEnable set to false
+			createInfoColorBlending.logicOp = VK_LOGIC_OP_COPY; // Optional
+			createInfoColorBlending.attachmentCount = 1;
+			createInfoColorBlending.pAttachments = &createInfoColorBlendAttachment;
+			createInfoColorBlending.blendConstants[0] = 0.0f; // Optional
+			createInfoColorBlending.blendConstants[1] = 0.0f; // Optional
+			createInfoColorBlending.blendConstants[2] = 0.0f; // Optional
+			createInfoColorBlending.blendConstants[3] = 0.0f; // Optional
+
+			VkPipelineDepthStencilStateCreateInfo depthStencil{};
+			depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+			depthStencil.depthTestEnable = VK_TRUE;
+			depthStencil.depthWriteEnable = VK_TRUE;
+			depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+			depthStencil.depthBoundsTestEnable = VK_FALSE;
+			depthStencil.minDepthBounds = 0.0f; // Optional
+			depthStencil.maxDepthBounds = 1.0f; // Optional
+			depthStencil.stencilTestEnable = VK_FALSE;
+			depthStencil.front = {}; // Optional
+			depthStencil.back = {}; // Optional
+
+			// Create the pipeline
+			VkGraphicsPipelineCreateInfo createInfoGraphicsPipeline{};
+			createInfoGraphicsPipeline.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			createInfoGraphicsPipeline.flags = desc.flags;
+			createInfoGraphicsPipeline.stageCount = 2; // number of shader stages
+			createInfoGraphicsPipeline.pStages = shaderStages;
+			createInfoGraphicsPipeline.pVertexInputState = &createInfoVertexInput;
+			createInfoGraphicsPipeline.pInputAssemblyState = &createInfoInputAssembly;
+			createInfoGraphicsPipeline.pViewportState = &createInfoViewportState;
+			createInfoGraphicsPipeline.pRasterizationState = &createInfoRasterizerState;
+			createInfoGraphicsPipeline.pMultisampleState = &createInfoMultisampling;
+			createInfoGraphicsPipeline.pDepthStencilState = nullptr; // not used yet
+			createInfoGraphicsPipeline.pColorBlendState = &createInfoColorBlending;
+			createInfoGraphicsPipeline.pDynamicState = &createInfoDynamicState;
+			createInfoGraphicsPipeline.layout = desc.pipelineLayout;
+
+			// https://registry.khronos.org/vulkan/specs/1.3-extensions/html/chap8.html#renderpass-compatibility
+			createInfoGraphicsPipeline.renderPass = desc.renderPass;
+			createInfoGraphicsPipeline.subpass = 0; // idx
+
+			// without a render pass the attachment formats are all the pipeline needs to know
+			VkPipelineRenderingCreateInfo createInfoRendering{};
+			if (desc.renderPass == VK_NULL_HANDLE)
+			{
+				createInfoRendering.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+				createInfoRendering.colorAttachmentCount = 1;
+				createInfoRendering.pColorAttachmentFormats = &desc.colorFormat;
+				createInfoRendering.depthAttachmentFormat = desc.depthFormat;
+				createInfoRendering.stencilAttachmentFormat = Images::FormatHasStencilComponent(desc.depthFormat) ? desc.depthFormat : VK_FORMAT_UNDEFINED;
+
+				createInfoGraphicsPipeline.pNext = &createInfoRendering;
+			}
+
+			//Vulkan allows you to create a new graphics pipeline by deriving from an existing pipeline
+			createInfoGraphicsPipeline.basePipelineHandle = VK_NULL_HANDLE;
+			createInfoGraphicsPipeline.basePipelineIndex = -1;
+
+			// use depth stencil state for depth testing of fragment shaders for discard
+			createInfoGraphicsPipeline.pDepthStencilState = &depthStencil;
+
+			/* -- NOTE --
+			* A library only takes the state belonging to its parts, everything else is left null:
+			*   - VERTEX_INPUT_INTERFACE: vertex input and input assembly
+			*   - PRE_RASTERIZATION_SHADERS: vertex stage, viewport, rasterizer, dynamic state, layout and render pass
+			*   - FRAGMENT_SHADER: fragment stage, depth stencil, multisampling, layout and render pass
+			*   - FRAGMENT_OUTPUT_INTERFACE: blending, multisampling and render pass
+			*/
+			VkGraphicsPipelineLibraryCreateInfoEXT createInfoPipelineLibrary{};
+			if (libraryParts != 0)
+			{
+				createInfoPipelineLibrary.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+				createInfoPipelineLibrary.flags = libraryParts;
+
+				createInfoPipelineLibrary.pNext = createInfoGraphicsPipeline.pNext;
+				createInfoGraphicsPipeline.pNext = &createInfoPipelineLibrary;
+				createInfoGraphicsPipeline.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+				bool bVertexInput = libraryParts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+				bool bPreRasterization = libraryParts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+				bool bFragmentShader = libraryParts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+				bool bFragmentOutput = libraryParts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+				// vertex stage first, so a pre-rasterization only library can simply take the first stage
+				createInfoGraphicsPipeline.stageCount = (bPreRasterization ? 1 : 0) + (bFragmentShader ? 1 : 0);
+				createInfoGraphicsPipeline.pStages = bPreRasterization ? &shaderStages[0] : &shaderStages[1];
+
+				if (!bVertexInput)
+				{
+					createInfoGraphicsPipeline.pVertexInputState = nullptr;
+					createInfoGraphicsPipeline.pInputAssemblyState = nullptr;
+				}
+
+				if (!bPreRasterization)
+				{
+					createInfoGraphicsPipeline.pViewportState = nullptr;
+					createInfoGraphicsPipeline.pRasterizationState = nullptr;
+					createInfoGraphicsPipeline.pDynamicState = nullptr;
+				}
+
+				if (!bFragmentShader)
+				{
+					createInfoGraphicsPipeline.pDepthStencilState = nullptr;
+				}
+
+				if (!bFragmentShader && !bFragmentOutput)
+				{
+					createInfoGraphicsPipeline.pMultisampleState = nullptr;
+				}
+
+				if (!bFragmentOutput)
+				{
+					createInfoGraphicsPipeline.pColorBlendState = nullptr;
+				}
+
+				if (!bPreRasterization && !bFragmentShader)
+				{
+					createInfoGraphicsPipeline.layout = VK_NULL_HANDLE;
+				}
+
+				if (!bPreRasterization && !bFragmentShader && !bFragmentOutput)
+				{
+					createInfoGraphicsPipeline.renderPass = VK_NULL_HANDLE;
+				}
+			}
+
+			// the engine's pipeline cache is shared by every window and persisted between runs
+			return vkCreateGraphicsPipelines(vkDevice, vkPipelineCache, 1, &createInfoGraphicsPipeline, nullptr, &outPipeline);
+		}
+
+		/*
+		* Link the four graphics pipeline library parts into a complete pipeline.
+		*	A fast link is near free, an optimized link costs about as much as a monolithic compile but runs as fast
+		*/
+		static VkResult LinkGraphicsPipeline(VkDevice vkDevice, VkPipelineCache vkPipelineCache, const std::array<VkPipeline, 4>& libraries, const GraphicsPipelineDesc& desc, bool bOptimize, VkPipeline& outPipeline)
+		{
+			VkPipelineLibraryCreateInfoKHR createInfoLibraries{};
+			createInfoLibraries.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+			createInfoLibraries.libraryCount = static_cast<uint32_t>(libraries.size());
+			createInfoLibraries.pLibraries = libraries.data();
+
+			VkGraphicsPipelineCreateInfo createInfoGraphicsPipeline{};
+			createInfoGraphicsPipeline.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			createInfoGraphicsPipeline.pNext = &createInfoLibraries;
+			createInfoGraphicsPipeline.flags = desc.flags | (bOptimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0);
+			createInfoGraphicsPipeline.layout = desc.pipelineLayout;
+			createInfoGraphicsPipeline.basePipelineHandle = VK_NULL_HANDLE;
+			createInfoGraphicsPipeline.basePipelineIndex = -1;
+
+			return vkCreateGraphicsPipelines(vkDevice, vkPipelineCache, 1, &createInfoGraphicsPipeline, nullptr, &outPipeline);
+		}
+	}
+
+	/*
+	* Handle to a pipeline being built on the compile service.
+	*
+	* With graphics pipeline libraries the handle is first filled with a fast-linked pipeline and later
+	*	upgraded to the optimized link, Get() always returns the best pipeline available so far.
+	*/
+	class AsyncPipeline
+	{
+	public:
+		VkPipeline Get() const
+		{
+			return pipeline.load(std::memory_order_acquire);
+		}
+
+		/*
+		* No further upgrade is coming
+		*/
+		bool IsDone() const
+		{
+			return bDone.load(std::memory_order_acquire);
+		}
+
+		/*
+		* Block until the compile finished or failed, only for shutdown/teardown paths
+		*/
+		void Wait() const
+		{
+			std::unique_lock<std::mutex> lock(doneMutex);
+			doneCondition.wait(lock, [this]() { return bDone.load(std::memory_order_acquire); });
+		}
+
+		/*
+		* Destroy the pipeline and everything it replaced, only once IsDone() and the GPU is idle
+		*/
+		void Destroy(VkDevice vkDevice)
+		{
+			std::lock_guard<std::mutex> lock(doneMutex);
+
+			vkDestroyPipeline(vkDevice, pipeline.exchange(VK_NULL_HANDLE, std::memory_order_acq_rel), nullptr);
+			for (VkPipeline replacedPipeline : replacedPipelines)
+			{
+				vkDestroyPipeline(vkDevice, replacedPipeline, nullptr);
+			}
+			replacedPipelines.clear();
+		}
+
+	private:
+		void Publish(VkPipeline _pipeline)
+		{
+			if (_pipeline == VK_NULL_HANDLE)
+			{
+				return;
+			}
+
+			// a replaced pipeline may still be recorded in a frame in flight, keep it until shutdown
+			std::lock_guard<std::mutex> lock(doneMutex);
+			VkPipeline previousPipeline = pipeline.exchange(_pipeline, std::memory_order_acq_rel);
+			if (previousPipeline != VK_NULL_HANDLE)
+			{
+				replacedPipelines.push_back(previousPipeline);
+			}
+		}
+
+		void Finish()
+		{
+			std::lock_guard<std::mutex> lock(doneMutex);
+			bDone.store(true, std::memory_order_release);
+			doneCondition.notify_all();
+		}
+
+		void Complete(VkPipeline _pipeline)
+		{
+			Publish(_pipeline);
+			Finish();
+		}
+
+	private:
+		std::atomic<VkPipeline> pipeline{ VK_NULL_HANDLE };
+		std::atomic<bool> bDone{ false };
+
+		std::vector<VkPipeline> replacedPipelines;
+
+		mutable std::mutex doneMutex;
+		mutable std::condition_variable doneCondition;
+
+		friend class PipelineCompileService;
+	};
+
+	/*
+	* VK_EXT_graphics_pipeline_library parts, each compiled once per distinct state and shared by every pipeline linked from it.
+	*	Keys only hold the desc fields the part actually consumes, so e.g. every pipeline shares one vertex input library.
+	*/
+	class GraphicsPipelineLibraryCache
+	{
+	public:
+		static constexpr std::array<VkGraphicsPipelineLibraryFlagBitsEXT, 4> LIBRARY_PARTS =
+		{
+			VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+			VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+			VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+			VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+		};
+
+		/*
+		* Fetch every part for desc without compiling anything, false if any is missing
+		*/
+		bool TryGet(const GraphicsPipelineDesc& desc, std::array<VkPipeline, 4>& outLibraries) const
+		{
+			std::lock_guard<std::mutex> lock(librariesMutex);
+
+			for (size_t i = 0; i < LIBRARY_PARTS.size(); i++)
+			{
+				auto itLibrary = libraries.find(MakeKey(LIBRARY_PARTS[i], desc));
+				if (itLibrary == libraries.end())
+				{
+					return false;
+				}
+
+				outLibraries[i] = itLibrary->second;
+			}
+
+			return true;
+		}
+
+		/*
+		* Fetch every part for desc, compiling the missing ones on the calling thread
+		*/
+		VkResult GetOrCreate(VkDevice vkDevice, VkPipelineCache vkPipelineCache, const GraphicsPipelineDesc& desc, std::array<VkPipeline, 4>& outLibraries)
+		{
+			for (size_t i = 0; i < LIBRARY_PARTS.size(); i++)
+			{
+				LibraryKey libraryKey = MakeKey(LIBRARY_PARTS[i], desc);
+
+				{
+					std::lock_guard<std::mutex> lock(librariesMutex);
+
+					auto itLibrary = libraries.find(libraryKey);
+					if (itLibrary != libraries.end())
+					{
+						outLibraries[i] = itLibrary->second;
+						continue;
+					}
+				}
+
+				// compile outside the lock so workers building unrelated parts don't serialize
+				VkPipeline library = VK_NULL_HANDLE;
+				VkResult createLibraryRes = Pipelines::CreateGraphicsPipeline(vkDevice, vkPipelineCache, desc, library, LIBRARY_PARTS[i]);
+				if (createLibraryRes != VK_SUCCESS)
+				{
+					return createLibraryRes;
+				}
+
+				std::lock_guard<std::mutex> lock(librariesMutex);
+
+				// another worker may have built the same part meanwhile, keep theirs
+				auto [itLibrary, bInserted] = libraries.emplace(libraryKey, library);
+				if (!bInserted)
+				{
+					vkDestroyPipeline(vkDevice, library, nullptr);
+				}
+
+				outLibraries[i] = itLibrary->second;
+			}
+
+			return VK_SUCCESS;
+		}
+
+		/*
+		* !! NOTE !! linked pipelines don't reference their libraries, so this is safe while they are still alive
+		*/
+		void Shutdown(VkDevice vkDevice)
+		{
+			std::lock_guard<std::mutex> lock(librariesMutex);
+
+			for (auto& [libraryKey, library] : libraries)
+			{
+				vkDestroyPipeline(vkDevice, library, nullptr);
+			}
+			libraries.clear();
+		}
+
+	private:
+		// part, shader module, layout, render pass, color format, depth format, samples, sample shading, blending, shader features, create flags
+		using LibraryKey = std::tuple<uint32_t, VkShaderModule, VkPipelineLayout, VkRenderPass, VkFormat, VkFormat, VkSampleCountFlagBits, bool, bool, uint32_t, VkPipelineCreateFlags>;
+
+		/*
+		* With dynamic rendering the render pass is null, so the pre-rasterization part is shared across attachment formats,
+		*	the fragment part only depends on the depth format and only the output part on both
+		*/
+		static LibraryKey MakeKey(VkGraphicsPipelineLibraryFlagBitsEXT part, const GraphicsPipelineDesc& desc)
+		{
+			switch (part)
+			{
+			case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+				return { part, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED, VK_SAMPLE_COUNT_1_BIT, false, false, 0, desc.flags };
+			case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+				return { part, desc.vertexShaderModule, desc.pipelineLayout, desc.renderPass, VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED, VK_SAMPLE_COUNT_1_BIT, false, false, 0, desc.flags };
+			case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+				return { part, desc.fragmentShaderModule, desc.pipelineLayout, desc.renderPass, VK_FORMAT_UNDEFINED, desc.depthFormat, desc.rasterizationSamples, desc.bSampleShading, false, desc.shaderFeatures, desc.flags };
+			default:
+				// multisample state has to match the fragment shader part's, so it is part of the output key too
+				return { part, VK_NULL_HANDLE, VK_NULL_HANDLE, desc.renderPass, desc.colorFormat, desc.depthFormat, desc.rasterizationSamples, desc.bSampleShading, desc.bBlendEnable, 0, desc.flags };
+			}
+		}
+
+	private:
+		mutable std::mutex librariesMutex;
+		std::map<LibraryKey, VkPipeline> libraries;
+	};
+
+	/*
+	* Builds pipelines on worker threads so creating one never stalls the frame loop.
+	*
+	* Callers keep drawing with whatever is already ready (a fallback or nothing) and pick up the
+	*	real pipeline from the AsyncPipeline handle as soon as it completes.
+	*
+	* With VK_EXT_graphics_pipeline_library pipelines are linked from cached library parts instead,
+	*	a fast link is handed out first and replaced by an optimized link built in the background.
+	*/
+	class PipelineCompileService
+	{
+	public:
+		PipelineCompileService()
+			: vkDevice(VK_NULL_HANDLE)
+			, pipelineCache(nullptr)
+			, bUseGraphicsPipelineLibrary(false)
+			, bStopping(false)
+		{
+
+		}
+
+		void Init(VkDevice _vkDevice, const PipelineCache& _pipelineCache, bool _bUseGraphicsPipelineLibrary, uint32_t threadCount = 0)
+		{
+			vkDevice = _vkDevice;
+			pipelineCache = &_pipelineCache;
+			bUseGraphicsPipelineLibrary = _bUseGraphicsPipelineLibrary;
+
+			// leave a core for the main thread
+			if (threadCount == 0)
+			{
+				threadCount = std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1;
+			}
+
+			for (uint32_t i = 0; i < threadCount; i++)
+			{
+				workers.emplace_back(&PipelineCompileService::WorkerLoop, this);
+			}
+		}
+
+		/*
+		* Queue a pipeline build, bHighPriority jobs (fallbacks) jump ahead of the queue.
+		*	When every library part is already cached the fast link happens right here, so the handle is usable on return.
+		*	!! NOTE !! desc's shader modules, layout and render pass must outlive the returned handle's completion
+		*/
+		std::shared_ptr<AsyncPipeline> Request(const GraphicsPipelineDesc& desc, bool bHighPriority = false)
+		{
+			std::shared_ptr<AsyncPipeline> asyncPipeline = std::make_shared<AsyncPipeline>();
+
+			if (!bUseGraphicsPipelineLibrary)
+			{
+				Enqueue(asyncPipeline, [this, desc](const std::shared_ptr<AsyncPipeline>& target) { BuildMonolithic(desc, *target); }, bHighPriority);
+				return asyncPipeline;
+			}
+
+			std::array<VkPipeline, 4> libraries;
+			if (libraryCache.TryGet(desc, libraries))
+			{
+				asyncPipeline->Publish(LinkLibraries(desc, libraries, false));
+				Enqueue(asyncPipeline, [this, desc, libraries](const std::shared_ptr<AsyncPipeline>& target) { target->Complete(LinkLibraries(desc, libraries, true)); }, false);
+			}
+			else
+			{
+				Enqueue(asyncPipeline, [this, desc](const std::shared_ptr<AsyncPipeline>& target) { BuildFromLibraries(desc, target); }, bHighPriority);
+			}
+
+			return asyncPipeline;
+		}
+
+		/*
+		* Drop every job that hasn't started yet, their handles finish with whatever they already hold
+		*/
+		void CancelPending()
+		{
+			std::deque<CompileJob> cancelledJobs;
+			{
+				std::lock_guard<std::mutex> lock(jobsMutex);
+				cancelledJobs.swap(jobs);
+			}
+
+			for (CompileJob& job : cancelledJobs)
+			{
+				job.asyncPipeline->Finish();
+			}
+		}
+
+		/*
+		* Stop the workers and release the library parts, queued jobs that never started are cancelled
+		*/
+		void Shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(jobsMutex);
+				bStopping = true;
+			}
+			jobsCondition.notify_all();
+
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+			workers.clear();
+
+			CancelPending();
+			libraryCache.Shutdown(vkDevice);
+		}
+
+	private:
+		struct CompileJob
+		{
+			std::function<void(const std::shared_ptr<AsyncPipeline>&)> build;
+			std::shared_ptr<AsyncPipeline> asyncPipeline;
+		};
+
+		void Enqueue(const std::shared_ptr<AsyncPipeline>& asyncPipeline, std::function<void(const std::shared_ptr<AsyncPipeline>&)> build, bool bHighPriority)
+		{
+			{
+				std::lock_guard<std::mutex> lock(jobsMutex);
+				if (bHighPriority)
+				{
+					jobs.push_front({ std::move(build), asyncPipeline });
+				}
+				else
+				{
+					jobs.push_back({ std::move(build), asyncPipeline });
+				}
+			}
+			jobsCondition.notify_one();
+		}
+
+		void BuildMonolithic(const GraphicsPipelineDesc& desc, AsyncPipeline& target)
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			VkResult createPipelineRes = Pipelines::CreateGraphicsPipeline(vkDevice, pipelineCache->Get(), desc, pipeline);
+
+			double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+			if (createPipelineRes != VK_SUCCESS)
+			{
+				SDL_Log("Failed to create graphics pipeline Error: %d", (int)createPipelineRes);
+				pipeline = VK_NULL_HANDLE;
+			}
+			else
+			{
+				SDL_Log("Pipeline compiled in %.2f ms (%s cache)", elapsedMs, pipelineCache->IsWarm() ? "warm" : "cold");
+			}
+
+			target.Complete(pipeline);
+		}
+
+		/*
+		* Compile the missing parts, hand out a fast link straight away and queue the optimized link behind other work
+		*/
+		void BuildFromLibraries(const GraphicsPipelineDesc& desc, const std::shared_ptr<AsyncPipeline>& target)
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			std::array<VkPipeline, 4> libraries;
+			VkResult createLibrariesRes = libraryCache.GetOrCreate(vkDevice, pipelineCache->Get(), desc, libraries);
+			if (createLibrariesRes != VK_SUCCESS)
+			{
+				SDL_Log("Failed to create graphics pipeline library Error: %d, falling back to a monolithic build", (int)createLibrariesRes);
+				BuildMonolithic(desc, *target);
+				return;
+			}
+
+			target->Publish(LinkLibraries(desc, libraries, false));
+
+			double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+			SDL_Log("Pipeline libraries ready and fast-linked in %.2f ms (%s cache)", elapsedMs, pipelineCache->IsWarm() ? "warm" : "cold");
+
+			Enqueue(target, [this, desc, libraries](const std::shared_ptr<AsyncPipeline>& upgradeTarget) { upgradeTarget->Complete(LinkLibraries(desc, libraries, true)); }, false);
+		}
+
+		VkPipeline LinkLibraries(const GraphicsPipelineDesc& desc, const std::array<VkPipeline, 4>& libraries, bool bOptimize)
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			VkResult linkPipelineRes = Pipelines::LinkGraphicsPipeline(vkDevice, pipelineCache->Get(), libraries, desc, bOptimize, pipeline);
+			if (linkPipelineRes != VK_SUCCESS)
+			{
+				SDL_Log("Failed to link graphics pipeline (%s) Error: %d", bOptimize ? "optimized" : "fast", (int)linkPipelineRes);
+				return VK_NULL_HANDLE;
+			}
+
+			if (bOptimize)
+			{
+				double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+				SDL_Log("Pipeline optimized link in %.2f ms", elapsedMs);
+			}
+
+			return pipeline;
+		}
+
+		void WorkerLoop()
+		{
+			while (true)
+			{
+				CompileJob job;
+				{
+					std::unique_lock<std::mutex> lock(jobsMutex);
+					jobsCondition.wait(lock, [this]() { return bStopping || !jobs.empty(); });
+
+					if (bStopping)
+					{
+						return;
+					}
+
+					job = std::move(jobs.front());
+					jobs.pop_front();
+				}
+
+				job.build(job.asyncPipeline);
+			}
+		}
+
+	private:
+		VkDevice vkDevice;
+		const PipelineCache* pipelineCache;
+
+		bool bUseGraphicsPipelineLibrary;
+		GraphicsPipelineLibraryCache libraryCache;
+
+		std::vector<std::thread> workers;
+
+		std::mutex jobsMutex;
+		std::condition_variable jobsCondition;
+		std::deque<CompileJob> jobs;
+		bool bStopping;
+	};
+
+	/*
+	* Everything needed to rebuild a graphics pipeline from scratch in a later session.
+	*	Only plain values, handles are resolved by the PipelineRegistry when the pipeline is built.
+	*/
+	struct PipelineStateKey
+	{
+		// embedded shader name (see VEmbeddedShaders.h) or a .spv path
+		std::string vertexShaderPath;
+		std::string fragmentShaderPath;
+
+		uint32_t vertexLayout = 0; // 0 - Vertex (pos, color, texCoord), the only layout so far
+
+		// render pass compatibility
+		VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+		VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+		VkSampleCountFlagBits rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		bool bSampleShading = true;
+		bool bBlendEnable = false;
+
+		uint32_t shaderFeatures = ShaderFeatures::Textured; // specialization constants, variants share one shader module
+
+		// pipeline layout compatibility, filled in by the registry
+		DescriptorBackendType descriptorBackendType = DescriptorBackendType::Auto;
+
+		bool operator<(const PipelineStateKey& other) const
+		{
+			return AsTuple() < other.AsTuple();
+		}
+
+		/*
+		* One manifest line, space separated. Shader paths are quoted so spaces in them survive, an unquoted path from an
+		*	older manifest still reads back as a single word
+		*/
+		std::string Serialize() const
+		{
+			std::ostringstream stream;
+			stream
+				<< std::quoted(vertexShaderPath) << ' '
+				<< std::quoted(fragmentShaderPath) << ' '
+				<< vertexLayout << ' '
+				<< (int)colorFormat << ' '
+				<< (int)depthFormat << ' '
+				<< (int)rasterizationSamples << ' '
+				<< bSampleShading << ' '
+				<< bBlendEnable << ' '
+				<< shaderFeatures << ' '
+				<< (int)descriptorBackendType;
+
+			return stream.str();
+		}
+
+		static bool Deserialize(const std::string& line, PipelineStateKey& outKey)
+		{
+			int colorFormat = 0, depthFormat = 0, rasterizationSamples = 0, descriptorBackendType = 0;
+
+			std::istringstream stream(line);
+			stream
+				>> std::quoted(outKey.vertexShaderPath)
+				>> std::quoted(outKey.fragmentShaderPath)
+				>> outKey.vertexLayout
+				>> colorFormat
+				>> depthFormat
+				>> rasterizationSamples
+				>> outKey.bSampleShading
+				>> outKey.bBlendEnable
+				>> outKey.shaderFeatures
+				>> descriptorBackendType;
+
+			if (stream.fail())
+			{
+				return false;
+			}
+
+			outKey.colorFormat = (VkFormat)colorFormat;
+			outKey.depthFormat = (VkFormat)depthFormat;
+			outKey.rasterizationSamples = (VkSampleCountFlagBits)rasterizationSamples;
+			outKey.descriptorBackendType = (DescriptorBackendType)descriptorBackendType;
+
+			return true;
+		}
+
+	private:
+		auto AsTuple() const
+		{
+			return std::tie(vertexShaderPath, fragmentShaderPath, vertexLayout, colorFormat, depthFormat, rasterizationSamples, bSampleShading, bBlendEnable, shaderFeatures, descriptorBackendType);
+		}
+	};
+
+	/*
+	* Engine wide owner of graphics pipelines, deduplicated by PipelineStateKey, and of the objects windows share
+	*	regardless of count: render passes (reference counted per format set), the set 0 layout and the pipeline layout.
+	*
+	* Every state acquired by a window during the session is written to a manifest on shutdown,
+	*	the next launch queues all of them on the compile service at startup so first use never stalls,
+	*	even when the driver's pipeline cache was invalidated.
+	*/
+	class PipelineRegistry
+	{
+	public:
+		PipelineRegistry()
+			: vkDevice(VK_NULL_HANDLE)
+			, pipelineCompileService(nullptr)
+			, descriptorBackendType(DescriptorBackendType::Auto)
+			, pipelineLayout(VK_NULL_HANDLE)
+			, bDynamicRendering(false)
+		{
+
+		}
+
+		/*
+		* Create the layout every registry pipeline is built against, matching what windows create for themselves.
+		*	With _bDynamicRendering pipelines are built against attachment formats and no render passes are created
+		*/
+		void Init(VkDevice _vkDevice, VkPhysicalDevice vkPhysicalDevice, PipelineCompileService& _pipelineCompileService, DescriptorBackendType _descriptorBackendType, VkDescriptorSetLayout textureSetLayout, const std::string& _manifestPath, bool _bDynamicRendering)
+		{
+			vkDevice = _vkDevice;
+			bDynamicRendering = _bDynamicRendering;
+			pipelineCompileService = &_pipelineCompileService;
+			descriptorBackendType = _descriptorBackendType;
+			manifestPath = _manifestPath;
+
+			frameSetBackend = Descriptors::CreateBackend(descriptorBackendType, vkPhysicalDevice);
+			frameSetBackend->InitSetLayout(vkDevice, Descriptors::GetFrameSetBindings());
+
+			if (Pipelines::CreatePipelineLayout(vkDevice, frameSetBackend->GetSetLayout(), textureSetLayout, pipelineLayout) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to create pipeline registry layout!");
+			}
+		}
+
+#if VIGOR_RUNTIME_SHADER_COMPILATION
+		void SetShaderCompiler(ShaderCompiler* _shaderCompiler)
+		{
+			shaderCompiler = _shaderCompiler;
+		}
+#endif // VIGOR_RUNTIME_SHADER_COMPILATION
+
+		/*
+		* Queue every pipeline recorded by the previous session, returns how many were queued
+		*/
+		uint32_t Prewarm()
+		{
+			std::vector<char> manifestData;
+			if (!Filesystem::TryRead(manifestPath, manifestData))
+			{
+				return 0;
+			}
+
+			std::istringstream stream(std::string(manifestData.begin(), manifestData.end()));
+
+			std::string line;
+			std::getline(stream, line);
+			if (line.rfind(MANIFEST_HEADER, 0) != 0)
+			{
+				SDL_Log("Pipeline manifest at %s has an unknown format, skipping pre-warm", manifestPath.c_str());
+				return 0;
+			}
+
+			uint32_t queuedCount = 0;
+			while (std::getline(stream, line))
+			{
+				PipelineStateKey pipelineStateKey;
+				if (!PipelineStateKey::Deserialize(line, pipelineStateKey))
+				{
+					continue;
+				}
+
+				// layouts built for another descriptor backend are not compatible with this session's windows
+				if (pipelineStateKey.descriptorBackendType != descriptorBackendType)
+				{
+					continue;
+				}
+
+				// shaders moved or deleted since the manifest was written, never built so the next save drops the entry
+				VkShaderModule shaderModule = VK_NULL_HANDLE;
+				if (!TryGetShaderModule(pipelineStateKey.vertexShaderPath, shaderModule) || !TryGetShaderModule(pipelineStateKey.fragmentShaderPath, shaderModule))
+				{
+					SDL_Log("Pipeline manifest entry uses a missing shader, skipping: %s", line.c_str());
+					continue;
+				}
+
+				if (pipelines.find(pipelineStateKey) == pipelines.end())
+				{
+					Build(pipelineStateKey, false);
+					queuedCount++;
+				}
+			}
+
+			SDL_Log("Pipeline pre-warm: %u pipelines queued from %s", queuedCount, manifestPath.c_str());
+			return queuedCount;
+		}
+
+		/*
+		* Shared handle to the pipeline for key, queued on the compile service the first time it is seen
+		*/
+		std::shared_ptr<AsyncPipeline> Acquire(PipelineStateKey key, bool bHighPriority = false)
+		{
+			key.descriptorBackendType = descriptorBackendType;
+
+			auto itPipeline = pipelines.find(key);
+			if (itPipeline == pipelines.end())
+			{
+				itPipeline = Build(key, bHighPriority);
+			}
+
+			itPipeline->second.bUsed = true;
+			return itPipeline->second.asyncPipeline;
+		}
+
+		/*
+		* Windows begin rendering with vkCmdBeginRendering instead of a render pass and framebuffers
+		*/
+		bool IsDynamicRendering() const
+		{
+			return bDynamicRendering;
+		}
+
+		/*
+		* Render pass shared by every window and pipeline using these formats, reference counted.
+		*	Any pass from here is compatible with every registry pipeline built for the same formats
+		*/
+		VkRenderPass AcquireRenderPass(VkFormat colorFormat, VkFormat depthFormat, VkSampleCountFlagBits rasterizationSamples)
+		{
+			RenderPassKey renderPassKey = { colorFormat, depthFormat, rasterizationSamples };
+
+			auto itRenderPass = renderPasses.find(renderPassKey);
+			if (itRenderPass == renderPasses.end())
+			{
+				VkRenderPass renderPass = VK_NULL_HANDLE;
+				VkResult createRenderPassRes = Pipelines::CreateRenderPass(vkDevice, colorFormat, depthFormat, rasterizationSamples, renderPass);
+				if (createRenderPassRes != VK_SUCCESS)
+				{
+					Vigor::Errors::RaiseRuntimeError("Failed to create shared render pass Error: {}\n\n", (int)createRenderPassRes);
+				}
+
+				itRenderPass = renderPasses.emplace(renderPassKey, SharedRenderPass{ renderPass, 0 }).first;
+			}
+
+			itRenderPass->second.refCount++;
+			return itRenderPass->second.renderPass;
+		}
+
+		void ReleaseRenderPass(VkRenderPass renderPass)
+		{
+			auto itRenderPass = std::find_if(renderPasses.begin(), renderPasses.end(), [renderPass](const auto& entry) { return entry.second.renderPass == renderPass; });
+			if (itRenderPass == renderPasses.end())
+			{
+				return;
+			}
+
+			if (--itRenderPass->second.refCount == 0)
+			{
+				vkDestroyRenderPass(vkDevice, renderPass, nullptr);
+				renderPasses.erase(itRenderPass);
+			}
+		}
+
+		/*
+		* Set 0 layout for DescriptorBackend::ShareSetLayout, lives as long as the registry
+		*/
+		VkDescriptorSetLayout GetFrameSetLayout() const
+		{
+			return frameSetBackend->GetSetLayout();
+		}
+
+		/*
+		* Layout every registry pipeline is built against, windows bind with it directly
+		*/
+		VkPipelineLayout GetPipelineLayout() const
+		{
+			return pipelineLayout;
+		}
+
+		/*
+		* Wait for outstanding builds, destroy everything and write the manifest.
+		*	!! NOTE !! call before the compile service shuts down
+		*/
+		void Shutdown()
+		{
+			SaveManifest();
+
+			// pre-warm builds and optimized links nobody is waiting on aren't worth finishing
+			pipelineCompileService->CancelPending();
+
+			for (auto& [pipelineStateKey, entry] : pipelines)
+			{
+				entry.asyncPipeline->Wait();
+				entry.asyncPipeline->Destroy(vkDevice);
+			}
+			pipelines.clear();
+
+			for (auto& [shaderPath, shaderModule] : shaderModules)
+			{
+				vkDestroyShaderModule(vkDevice, shaderModule, nullptr);
+			}
+			shaderModules.clear();
+
+			for (auto& [renderPassKey, sharedRenderPass] : renderPasses)
+			{
+				vkDestroyRenderPass(vkDevice, sharedRenderPass.renderPass, nullptr);
+			}
+			renderPasses.clear();
+
+			vkDestroyPipelineLayout(vkDevice, pipelineLayout, nullptr);
+			frameSetBackend->Shutdown(vkDevice);
+		}
+
+	private:
+		struct PipelineEntry
+		{
+			std::shared_ptr<AsyncPipeline> asyncPipeline;
+			bool bUsed = false; // acquired by a window this session, pre-warmed only entries are not carried over
+		};
+
+		using RenderPassKey = std::tuple<VkFormat, VkFormat, VkSampleCountFlagBits>;
+
+		struct SharedRenderPass
+		{
+			VkRenderPass renderPass = VK_NULL_HANDLE;
+			uint32_t refCount = 0; // windows plus registry pipelines, the latter only let go at shutdown
+		};
+
+		std::map<PipelineStateKey, PipelineEntry>::iterator Build(const PipelineStateKey& key, bool bHighPriority)
+		{
+			GraphicsPipelineDesc pipelineDesc{};
+			pipelineDesc.vertexShaderModule = GetShaderModule(key.vertexShaderPath);
+			pipelineDesc.fragmentShaderModule = GetShaderModule(key.fragmentShaderPath);
+			pipelineDesc.pipelineLayout = pipelineLayout;
+			pipelineDesc.renderPass = bDynamicRendering ? VK_NULL_HANDLE : AcquireRenderPass(key.colorFormat, key.depthFormat, key.rasterizationSamples); // held until shutdown
+			pipelineDesc.colorFormat = key.colorFormat;
+			pipelineDesc.depthFormat = key.depthFormat;
+			pipelineDesc.rasterizationSamples = key.rasterizationSamples;
+			pipelineDesc.bSampleShading = key.bSampleShading;
+			pipelineDesc.bBlendEnable = key.bBlendEnable;
+			pipelineDesc.shaderFeatures = key.shaderFeatures;
+			pipelineDesc.flags = frameSetBackend->GetPipelineCreateFlags();
+
+			PipelineEntry entry{};
+			entry.asyncPipeline = pipelineCompileService->Request(pipelineDesc, bHighPriority);
+
+			return pipelines.emplace(key, entry).first;
+		}
+
+		VkShaderModule GetShaderModule(const std::string& shaderPath)
+		{
+			VkShaderModule shaderModule = VK_NULL_HANDLE;
+			if (!TryGetShaderModule(shaderPath, shaderModule))
+			{
+				Vigor::Errors::RaiseRuntimeError("Failed to read shader: {}\n\n", shaderPath);
+			}
+
+			return shaderModule;
+		}
+
+		/*
+		* Returns false if shaderPath is neither embedded nor a readable .spv file.
+		*	Modules stay alive until shutdown as queued builds may still reference them
+		*/
+		bool TryGetShaderModule(const std::string& shaderPath, VkShaderModule& outShaderModule)
+		{
+			auto itShaderModule = shaderModules.find(shaderPath);
+			if (itShaderModule != shaderModules.end())
+			{
+				outShaderModule = itShaderModule->second;
+				return true;
+			}
+
+			// embedded SPIR-V first, anything else is a .spv path
+			VkShaderModule shaderModule = VK_NULL_HANDLE;
+#if VIGOR_RUNTIME_SHADER_COMPILATION
+			// development builds take the current GLSL over the embedded copy, a broken edit falls back to it
+			std::vector<uint32_t> compiledSpirv;
+			if (shaderCompiler != nullptr && shaderCompiler->Compile(shaderPath, compiledSpirv))
+			{
+				shaderModule = Shaders::CreateShaderModule(compiledSpirv.data(), compiledSpirv.size(), vkDevice);
+			}
+			else
+#endif // VIGOR_RUNTIME_SHADER_COMPILATION
+			if (const EmbeddedShaders::EmbeddedShader* embeddedShader = EmbeddedShaders::Find(shaderPath))
+			{
+				shaderModule = Shaders::CreateShaderModule(embeddedShader->code, embeddedShader->wordCount, vkDevice);
+			}
+			else
+			{
+				std::vector<char> shaderCode;
+				if (!Filesystem::TryRead(shaderPath, shaderCode))
+				{
+					return false;
+				}
+
+				shaderModule = Shaders::CreateShaderModule(shaderCode, vkDevice);
+			}
+			shaderModules.emplace(shaderPath, shaderModule);
+
+			outShaderModule = shaderModule;
+			return true;
+		}
+
+		void SaveManifest() const
+		{
+			std::string manifest = std::string(MANIFEST_HEADER) + "\n";
+			for (const auto& [pipelineStateKey, entry] : pipelines)
+			{
+				if (entry.bUsed)
+				{
+					manifest += pipelineStateKey.Serialize() + "\n";
+				}
+			}
+
+			if (!Filesystem::WriteAtomic(manifestPath, manifest.data(), manifest.size()))
+			{
+				SDL_Log("Failed to write pipeline manifest to %s", manifestPath.c_str());
+			}
+		}
+
+	private:
+		static constexpr const char* MANIFEST_HEADER = "VigorPipelineManifest 2";
+
+		VkDevice vkDevice;
+		PipelineCompileService* pipelineCompileService;
+
+		DescriptorBackendType descriptorBackendType;
+		std::unique_ptr<DescriptorBackend> frameSetBackend; // only used for its set 0 layout
+		VkPipelineLayout pipelineLayout;
+		bool bDynamicRendering;
+
+		std::map<PipelineStateKey, PipelineEntry> pipelines;
+		std::map<std::string, VkShaderModule> shaderModules;
+		std::map<RenderPassKey, SharedRenderPass> renderPasses;
+
+		std::string manifestPath;
+
+#if VIGOR_RUNTIME_SHADER_COMPILATION
+		ShaderCompiler* shaderCompiler = nullptr;
+#endif // VIGOR_RUNTIME_SHADER_COMPILATION
+	};
+}
@@ -0,0 +1,1502 @@
+#pragma once
+
+#include <cmath>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <unordered_map>
+
+#include <SDL.h>
+
+#ifndef GLM_ENABLE_EXPERIMENTAL
+#define GLM_ENABLE_EXPERIMENTAL
+#endif
+#include <glm/gtx/hash.hpp>
+
+namespace Vigor
+{
+	/*
+	* Lets stb_image decode straight into mapped staging memory.
+	*
+	* stb_image always allocates its own output, so while a target is set on this thread the first allocation of the
+	*	expected output size (plus a few bytes, the JPEG path asks for one extra) is handed the target and freeing it is a no-op. If the decoder's final buffer turns
+	*	out to be a different one (an intermediate happened to match the size) the caller just copies, it is never wrong.
+	*/
+	namespace StagingDecode
+	{
+		constexpr size_t Slack = 16;
+
+		struct Target
+		{
+			void* data = nullptr;
+			size_t size = 0; // expected output size, data has room for size + Slack
+			bool bClaimed = false;
+		};
+
+		inline thread_local Target target;
+
+		static void* Malloc(size_t size)
+		{
+			if (target.data != nullptr && !target.bClaimed && size >= target.size && size <= target.size + Slack)
+			{
+				target.bClaimed = true;
+				return target.data;
+			}
+			return malloc(size);
+		}
+
+		static void* Realloc(void* data, size_t size)
+		{
+			if (data != nullptr && data == target.data)
+			{
+				// never the final output, move it to the heap and free the target up again
+				void* heapData = malloc(size);
+				if (heapData != nullptr)
+				{
+					memcpy(heapData, data, std::min(size, target.size + Slack));
+				}
+				target.bClaimed = false;
+				return heapData;
+			}
+			return realloc(data, size);
+		}
+
+		static void Free(void* data)
+		{
+			if (data != nullptr && data == target.data)
+			{
+				target.bClaimed = false;
+				return;
+			}
+			free(data);
+		}
+
+		struct ScopedTarget
+		{
+			ScopedTarget(void* data, size_t size)
+			{
+				target = { data, size, false };
+			}
+
+			~ScopedTarget()
+			{
+				target = {};
+			}
+		};
+	}
+}
+
+#define STBI_MALLOC(size) Vigor::StagingDecode::Malloc(size)
+#define STBI_REALLOC(data, size) Vigor::StagingDecode::Realloc(data, size)
+#define STBI_FREE(data) Vigor::StagingDecode::Free(data)
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VErrors.h"
+#include "VImages.h"
+#include "VMemory.h"
+#include "VEngineTypes.h"
+#include "VBindlessTextures.h"
+#include "VTextureContainer.h"
+#include "VTextureCompression.h"
+#include "VKtx2.h"
+#include "VFilesystem.h"
+#include "VStagingRing.h"
+#include "VParallel.h"
+
+namespace Vigor
+{
+	/*
+	* Index into a ResourcePool plus the generation of the slot it was handed out for.
+	*	Once the resource is released the slot's generation moves on, so stale handles resolve to nothing instead of a reused slot
+	*/
+	template <typename Tag>
+	struct ResourceHandle
+	{
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		bool IsValid() const
+		{
+			return index != UINT32_MAX;
+		}
+
+		bool operator==(const ResourceHandle& other) const
+		{
+			return index == other.index && generation == other.generation;
+		}
+	};
+
+	struct MeshTag;
+	struct TextureTag;
+
+	using MeshHandle = ResourceHandle<MeshTag>;
+	using TextureHandle = ResourceHandle<TextureTag>;
+
+	struct MeshResource
+	{
+		VkBuffer vertexBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
+
+		VkBuffer indexBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;
+
+		uint32_t indexCount = 0;
+
+		// model space bounding sphere, for screen size based texture streaming
+		glm::vec3 boundsCenter = glm::vec3(0.0f);
+		float boundsRadius = 0.0f;
+	};
+
+	struct TextureResource
+	{
+		VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+		uint32_t mipLevels = 1;
+		VkImage image = VK_NULL_HANDLE;
+		VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+		VkImageView imageView = VK_NULL_HANDLE;
+		VkSampler sampler = VK_NULL_HANDLE;
+		uint32_t textureSlot = 0; // bindless texture table slot
+
+		// Mip streaming, only textures mapped from a .vtex/KTX2 with their mips pre-built. The image holds chain levels
+		//	[baseMip, streamHeader.mipLevels), of which [residentMip, ...) have been uploaded and can be sampled
+		bool bStreamed = false;
+		std::string streamPath;
+		TextureContainer::Header streamHeader{};
+		uint32_t baseMip = 0;
+		uint32_t residentMip = 0;
+		uint32_t desiredMip = 0; // finest level asked for by this frame's feedback
+		uint64_t lastUsedFrame = 0;
+		VkDeviceSize residentBytes = 0;
+	};
+
+	/*
+	* Reference counted slots of T, deduplicated by key. Freed slots are reused with a bumped generation
+	*/
+	template <typename Tag, typename T>
+	class ResourcePool
+	{
+	public:
+		using Handle = ResourceHandle<Tag>;
+
+		/*
+		* Handle to the live resource for key with an extra reference, invalid if none is loaded
+		*/
+		Handle AcquireExisting(const std::string& key)
+		{
+			auto itSlot = keyToSlot.find(key);
+			if (itSlot == keyToSlot.end())
+			{
+				return {};
+			}
+
+			Slot& slot = slots[itSlot->second];
+			slot.refCount++;
+
+			return { itSlot->second, slot.generation };
+		}
+
+		Handle Add(const std::string& key, const T& resource)
+		{
+			uint32_t index;
+			if (!freeSlots.empty())
+			{
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				index = static_cast<uint32_t>(slots.size());
+				slots.emplace_back();
+			}
+
+			Slot& slot = slots[index];
+			slot.resource = resource;
+			slot.key = key;
+			slot.refCount = 1;
+
+			keyToSlot.emplace(key, index);
+
+			return { index, slot.generation };
+		}
+
+		const T* Get(Handle handle) const
+		{
+			if (!IsLive(handle))
+			{
+				return nullptr;
+			}
+
+			return &slots[handle.index].resource;
+		}
+
+		T* GetMutable(Handle handle)
+		{
+			if (!IsLive(handle))
+			{
+				return nullptr;
+			}
+
+			return &slots[handle.index].resource;
+		}
+
+		template <typename VisitFn>
+		void ForEach(VisitFn visit)
+		{
+			for (Slot& slot : slots)
+			{
+				if (slot.refCount > 0)
+				{
+					visit(slot.resource);
+				}
+			}
+		}
+
+		/*
+		* Drop a reference, returns true with the resource in outResource when it was the last one and should be destroyed
+		*/
+		bool Release(Handle handle, T& outResource)
+		{
+			if (!IsLive(handle))
+			{
+				return false;
+			}
+
+			Slot& slot = slots[handle.index];
+			if (--slot.refCount > 0)
+			{
+				return false;
+			}
+
+			outResource = slot.resource;
+
+			keyToSlot.erase(slot.key);
+			slot = Slot{ T{}, std::string(), slot.generation + 1, 0 };
+			freeSlots.push_back(handle.index);
+
+			return true;
+		}
+
+		/*
+		* Hand every live resource to destroy regardless of reference count, for shutdown
+		*/
+		template <typename DestroyFn>
+		void Clear(DestroyFn destroy)
+		{
+			for (Slot& slot : slots)
+			{
+				if (slot.refCount > 0)
+				{
+					destroy(slot.resource);
+				}
+			}
+
+			slots.clear();
+			freeSlots.clear();
+			keyToSlot.clear();
+		}
+
+	private:
+		struct Slot
+		{
+			T resource{};
+			std::string key;
+			uint32_t generation = 1;
+			uint32_t refCount = 0;
+		};
+
+		bool IsLive(Handle handle) const
+		{
+			return handle.index < slots.size() && slots[handle.index].generation == handle.generation && slots[handle.index].refCount > 0;
+		}
+
+	private:
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeSlots;
+		std::unordered_map<std::string, uint32_t> keyToSlot;
+	};
+
+	/*
+	* Engine wide owner of meshes and textures.
+	*
+	* Assets are keyed by their canonical path so every window asking for the same file shares one decode, one upload
+	*	and one bindless slot. Windows hold generational handles and release them on shutdown, the last release frees the GPU copy.
+	*/
+	class ResourceManager
+	{
+	public:
+		ResourceManager()
+			: vkDevice(VK_NULL_HANDLE)
+			, vkPhysicalDevice(VK_NULL_HANDLE)
+			, graphicsQueue(VK_NULL_HANDLE)
+			, commandPool(VK_NULL_HANDLE)
+			, textureTable(nullptr)
+			, bTextureCompressionBC(false)
+			, frameNumber(0)
+			, retiringTextureBytes(0)
+		{
+
+		}
+
+		void Init(VkDevice _vkDevice, VkPhysicalDevice _vkPhysicalDevice, const QueueFamilyIndicies& queueFamilyIndicies, const DeviceCapabilities& deviceCapabilities, BindlessTextureTable& _textureTable)
+		{
+			vkDevice = _vkDevice;
+			vkPhysicalDevice = _vkPhysicalDevice;
+			bTextureCompressionBC = deviceCapabilities.bTextureCompressionBC;
+			textureTable = &_textureTable;
+
+			vkGetDeviceQueue(vkDevice, queueFamilyIndicies.graphicsFamily.value(), 0, &graphicsQueue);
+
+			// uploads only, one-off command buffers
+			VkCommandPoolCreateInfo createInfoCommandPool{};
+			createInfoCommandPool.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			createInfoCommandPool.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			createInfoCommandPool.queueFamilyIndex = queueFamilyIndicies.graphicsFamily.value();
+
+			VkResult createCommandPoolRes = vkCreateCommandPool(vkDevice, &createInfoCommandPool, nullptr, &commandPool);
+			if (createCommandPoolRes != VK_SUCCESS)
+			{
+				Vigor::Errors::RaiseRuntimeError("Failed to create resource upload command pool Error: {}\n\n", (int)createCommandPoolRes);
+			}
+
+			stagingRing.Init(vkDevice, vkPhysicalDevice, graphicsQueue, commandPool, STAGING_RING_SIZE);
+		}
+
+		/*
+		* Load the .obj at modelPath unless it is already resident
+		*/
+		MeshHandle AcquireMesh(const std::string& modelPath)
+		{
+			std::string key = MakeKey(modelPath);
+
+			MeshHandle meshHandle = meshes.AcquireExisting(key);
+			if (meshHandle.IsValid())
+			{
+				return meshHandle;
+			}
+
+			std::vector<Vertex> vertices;
+			std::vector<uint32_t> indices;
+			LoadModel(modelPath, vertices, indices);
+
+			MeshResource mesh{};
+			InitVertexBuffer(vertices, mesh);
+			InitIndexBuffer(indices, mesh);
+			mesh.indexCount = static_cast<uint32_t>(indices.size());
+			ComputeMeshBounds(vertices, mesh);
+
+			SDL_Log("Loaded mesh %s (%zu vertices, %zu indices)", modelPath.c_str(), vertices.size(), indices.size());
+			return meshes.Add(key, mesh);
+		}
+
+		/*
+		* Load the image at texturePath, with mips and a bindless slot, unless it is already resident
+		*/
+		TextureHandle AcquireTexture(const std::string& texturePath)
+		{
+			std::string key = MakeKey(texturePath);
+
+			TextureHandle textureHandle = textures.AcquireExisting(key);
+			if (textureHandle.IsValid())
+			{
+				return textureHandle;
+			}
+
+			TextureResource texture{};
+			InitTextureImage(texturePath, texture);
+			InitTextureImageView(texture);
+			InitTextureSampler(texture);
+			InitTextureSlot(texture);
+
+			SDL_Log("Loaded texture %s (%u mips, format %d, slot %u)", texturePath.c_str(), texture.mipLevels, (int)texture.format, texture.textureSlot);
+			return textures.Add(key, texture);
+		}
+
+		/*
+		* nullptr once the handle has been released
+		*/
+		const MeshResource* GetMesh(MeshHandle meshHandle) const
+		{
+			return meshes.Get(meshHandle);
+		}
+
+		const TextureResource* GetTexture(TextureHandle textureHandle) const
+		{
+			return textures.Get(textureHandle);
+		}
+
+		/*
+		* Streaming feedback, a window drew textureHandle spread over projectedPixels on screen this frame.
+		*	Assumes the UVs cover the texture once across the mesh, the finest level wanted is the one with about a texel per pixel
+		*/
+		void ReportTextureUsage(TextureHandle textureHandle, float projectedPixels)
+		{
+			TextureResource* texture = textures.GetMutable(textureHandle);
+			if (texture == nullptr || !texture->bStreamed)
+			{
+				return;
+			}
+
+			const TextureContainer::Header& header = texture->streamHeader;
+			float texelsPerPixel = std::max(header.width, header.height) / std::max(projectedPixels, 1.0f);
+			uint32_t desiredMip = std::min(static_cast<uint32_t>(std::max(std::floor(std::log2(texelsPerPixel)), 0.0f)), header.mipLevels - 1);
+
+			// several windows may draw it, the largest on screen wins
+			if (texture->lastUsedFrame != frameNumber)
+			{
+				texture->desiredMip = desiredMip;
+				texture->lastUsedFrame = frameNumber;
+			}
+			else
+			{
+				texture->desiredMip = std::min(texture->desiredMip, desiredMip);
+			}
+		}
+
+		/*
+		* Once per frame, after every window has reported and the memory budget has been refreshed: retire images the GPU is
+		*	done with, then stream in the levels this frame asked for, largest shortfall first, within STREAMING_BYTES_PER_FRAME.
+		*	Growing a texture past the budget first shrinks the least recently used ones back towards their tail, and past
+		*	the high water mark textures still on screen lose their finest levels too
+		*/
+		void UpdateStreaming(uint32_t framesInFlight)
+		{
+			RetireTextures(framesInFlight);
+
+			uint32_t textureHeap = Memory::Budget().GetDeviceLocalHeap();
+			if (!Memory::Budget().Fits(textureHeap, 0, retiringTextureBytes, MemoryBudget::HighWaterFraction) && !MakeStreamingRoom(0, nullptr))
+			{
+				DegradeStreamedTextures();
+			}
+
+			std::vector<TextureResource*> wanting;
+			textures.ForEach([this, &wanting](TextureResource& texture)
+				{
+					if (texture.bStreamed && texture.lastUsedFrame == frameNumber && texture.desiredMip < texture.residentMip)
+					{
+						wanting.push_back(&texture);
+					}
+				});
+
+			std::sort(wanting.begin(), wanting.end(), [](const TextureResource* a, const TextureResource* b)
+				{
+					return a->residentMip - a->desiredMip > b->residentMip - b->desiredMip;
+				});
+
+			VkDeviceSize bytesThisFrame = 0;
+			for (TextureResource* texture : wanting)
+			{
+				if (bytesThisFrame >= STREAMING_BYTES_PER_FRAME)
+				{
+					break;
+				}
+
+				if (texture->desiredMip < texture->baseMip)
+				{
+					// settle for a coarser top level if nothing else can give memory back
+					uint32_t newBaseMip = texture->desiredMip;
+					while (newBaseMip < texture->baseMip && !MakeStreamingRoom(StreamedImageBytes(texture->streamHeader, newBaseMip) - texture->residentBytes, texture))
+					{
+						newBaseMip++;
+					}
+
+					if (newBaseMip < texture->baseMip)
+					{
+						ResizeStreamedTexture(*texture, newBaseMip);
+					}
+				}
+
+				if (!texture->bStreamed)
+				{
+					continue; // its file went away while resizing
+				}
+
+				StreamInLevels(*texture, bytesThisFrame);
+			}
+
+			stagingRing.Submit();
+			frameNumber++;
+		}
+
+		/*
+		* !! NOTE !! the GPU must be done with the resource, i.e. only after the releasing window has idled
+		*/
+		void Release(MeshHandle meshHandle)
+		{
+			MeshResource mesh;
+			if (meshes.Release(meshHandle, mesh))
+			{
+				DestroyMesh(mesh);
+			}
+		}
+
+		void Release(TextureHandle textureHandle)
+		{
+			TextureResource texture;
+			if (textures.Release(textureHandle, texture))
+			{
+				stagingRing.Flush(); // the image may still be the destination of an upload
+				DestroyTexture(texture);
+			}
+		}
+
+		void Shutdown()
+		{
+			stagingRing.Shutdown(); // lands any upload still in flight
+			RetireTextures(0);
+
+			meshes.Clear([this](MeshResource& mesh) { DestroyMesh(mesh); });
+			textures.Clear([this](TextureResource& texture) { DestroyTexture(texture); });
+
+			vkDestroyCommandPool(vkDevice, commandPool, nullptr);
+			commandPool = VK_NULL_HANDLE;
+		}
+
+	private:
+		/*
+		* Same file through different relative paths still maps to one resource
+		*/
+		static std::string MakeKey(const std::string& path)
+		{
+			std::error_code errorCode;
+			std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(path, errorCode);
+
+			return errorCode ? path : canonicalPath.generic_string();
+		}
+
+		void DestroyMesh(const MeshResource& mesh)
+		{
+			vkDestroyBuffer(vkDevice, mesh.indexBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, mesh.indexBufferMemory);
+
+			vkDestroyBuffer(vkDevice, mesh.vertexBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, mesh.vertexBufferMemory);
+		}
+
+		void DestroyTexture(const TextureResource& texture)
+		{
+			textureTable->UnregisterTexture(texture.textureSlot);
+
+			vkDestroySampler(vkDevice, texture.sampler, nullptr);
+			vkDestroyImageView(vkDevice, texture.imageView, nullptr);
+
+			vkDestroyImage(vkDevice, texture.image, nullptr);
+			Memory::FreeMemory(vkDevice, texture.imageMemory);
+		}
+
+		/*
+		* Fill the allocated levels above residentMip, coarse to fine, until this frame's byte allowance runs out.
+		*	At least one level goes up per frame so a single large level still makes progress
+		*/
+		void StreamInLevels(TextureResource& texture, VkDeviceSize& bytesThisFrame)
+		{
+			const TextureContainer::Header& header = texture.streamHeader;
+
+			uint32_t newResidentMip = texture.residentMip;
+			while (newResidentMip > std::max(texture.baseMip, texture.desiredMip))
+			{
+				VkDeviceSize levelBytes = header.levels[newResidentMip - 1].size;
+				if (newResidentMip != texture.residentMip && bytesThisFrame + levelBytes > STREAMING_BYTES_PER_FRAME)
+				{
+					break;
+				}
+
+				bytesThisFrame += levelBytes;
+				newResidentMip--;
+			}
+
+			if (newResidentMip == texture.residentMip)
+			{
+				return;
+			}
+
+			Filesystem::MappedFile mappedFile;
+			if (!mappedFile.Open(texture.streamPath) || mappedFile.Size() < header.levels[header.mipLevels - 1].offset + header.levels[header.mipLevels - 1].size)
+			{
+				SDL_Log("Streamed texture %s changed or went missing, keeping mip %u", texture.streamPath.c_str(), texture.residentMip);
+				texture.bStreamed = false;
+				return;
+			}
+
+			UploadLevels(header, mappedFile.Data(), texture.image, texture.format, texture.baseMip, newResidentMip, texture.residentMip, false);
+			texture.residentMip = newResidentMip;
+
+			// only the sampler changes, let the new levels be read
+			RetireTexture(VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, texture.sampler, 0, texture.textureSlot);
+			InitTextureSampler(texture);
+			InitTextureSlot(texture);
+		}
+
+		/*
+		* Reallocate the image to hold chain levels [newBaseMip, ...). The levels both images share are uploaded again from
+		*	the file rather than copied image to image, so the old image never has to leave SHADER_READ_ONLY
+		*/
+		void ResizeStreamedTexture(TextureResource& texture, uint32_t newBaseMip)
+		{
+			const TextureContainer::Header& header = texture.streamHeader;
+
+			Filesystem::MappedFile mappedFile;
+			if (!mappedFile.Open(texture.streamPath) || mappedFile.Size() < header.levels[header.mipLevels - 1].offset + header.levels[header.mipLevels - 1].size)
+			{
+				SDL_Log("Streamed texture %s changed or went missing, keeping mip %u", texture.streamPath.c_str(), texture.residentMip);
+				texture.bStreamed = false;
+				return;
+			}
+
+			uint32_t newResidentMip = std::max(texture.residentMip, newBaseMip); // shrinking drops the finer levels
+
+			VkImage image;
+			VkDeviceMemory imageMemory;
+			try
+			{
+				CreateStreamedImage(header, newBaseMip, texture.format, image, imageMemory);
+			}
+			catch (const std::runtime_error&)
+			{
+				// out of device memory despite the budget, keep what is resident rather than fail the frame
+				SDL_Log("Could not allocate mip %u of %s, keeping mip %u", newBaseMip, texture.streamPath.c_str(), texture.baseMip);
+				return;
+			}
+
+			UploadLevels(header, mappedFile.Data(), image, texture.format, newBaseMip, newResidentMip, header.mipLevels, true);
+
+			RetireTexture(texture.image, texture.imageMemory, texture.imageView, texture.sampler, texture.residentBytes, texture.textureSlot);
+			texture.residentBytes = StreamedImageBytes(header, newBaseMip);
+
+			texture.image = image;
+			texture.imageMemory = imageMemory;
+			texture.baseMip = newBaseMip;
+			texture.residentMip = newResidentMip;
+			texture.mipLevels = header.mipLevels - newBaseMip;
+
+			InitTextureImageView(texture);
+			InitTextureSampler(texture);
+			InitTextureSlot(texture);
+		}
+
+		/*
+		* Shrink other streamed textures until bytesNeeded more fits under the budget's target. Textures not drawn this frame
+		*	go back to their tail, least recently used first, ones still drawn only give up levels finer than they asked for
+		*/
+		bool MakeStreamingRoom(VkDeviceSize bytesNeeded, const TextureResource* requester)
+		{
+			uint32_t textureHeap = Memory::Budget().GetDeviceLocalHeap();
+			auto bFits = [&]()
+				{
+					return Memory::Budget().Fits(textureHeap, bytesNeeded, retiringTextureBytes, MemoryBudget::TargetFraction);
+				};
+
+			if (bFits())
+			{
+				return true;
+			}
+
+			auto trimTarget = [this](const TextureResource& texture)
+				{
+					return texture.lastUsedFrame == frameNumber ? texture.desiredMip : StreamingTailMip(texture.streamHeader);
+				};
+
+			std::vector<TextureResource*> candidates;
+			textures.ForEach([&](TextureResource& texture)
+				{
+					if (&texture != requester && texture.bStreamed && texture.baseMip < trimTarget(texture))
+					{
+						candidates.push_back(&texture);
+					}
+				});
+
+			std::sort(candidates.begin(), candidates.end(), [](const TextureResource* a, const TextureResource* b)
+				{
+					return a->lastUsedFrame < b->lastUsedFrame;
+				});
+
+			for (TextureResource* candidate : candidates)
+			{
+				ResizeStreamedTexture(*candidate, trimTarget(*candidate));
+				if (bFits())
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/*
+		* Still over budget with nothing idle left to evict, drop the finest level of the largest textures on screen until
+		*	back under the target. Growing again needs room the target leaves no space for, so this does not thrash
+		*/
+		void DegradeStreamedTextures()
+		{
+			uint32_t textureHeap = Memory::Budget().GetDeviceLocalHeap();
+
+			for (;;)
+			{
+				TextureResource* largest = nullptr;
+				textures.ForEach([&largest](TextureResource& texture)
+					{
+						if (texture.bStreamed && texture.baseMip < StreamingTailMip(texture.streamHeader) && (largest == nullptr || texture.residentBytes > largest->residentBytes))
+						{
+							largest = &texture;
+						}
+					});
+
+				if (largest == nullptr)
+				{
+					SDL_Log("Over the memory budget with every streamed texture at its tail");
+					return;
+				}
+
+				uint32_t previousBaseMip = largest->baseMip;
+				ResizeStreamedTexture(*largest, previousBaseMip + 1);
+				if (largest->bStreamed && largest->baseMip == previousBaseMip)
+				{
+					return; // could not even allocate the smaller image
+				}
+
+				if (Memory::Budget().Fits(textureHeap, 0, retiringTextureBytes, MemoryBudget::TargetFraction))
+				{
+					return;
+				}
+			}
+		}
+
+		/*
+		* Queue objects replaced by streaming for destruction once the frames that may still sample them have finished,
+		*	any of them may be VK_NULL_HANDLE. The bindless slot they were registered in goes back to the table at the same
+		*	time, queued frames index it by the slot they were recorded with
+		*/
+		void RetireTexture(VkImage image, VkDeviceMemory imageMemory, VkImageView imageView, VkSampler sampler, VkDeviceSize bytes, uint32_t textureSlot)
+		{
+			retiredTextures.push_back({ frameNumber, image, imageMemory, imageView, sampler, bytes, textureSlot });
+			retiringTextureBytes += bytes; // counted as free already, nothing new will be placed in it
+		}
+
+		/*
+		* framesInFlight of 0 destroys everything, for when the device is idle
+		*/
+		void RetireTextures(uint32_t framesInFlight)
+		{
+			while (!retiredTextures.empty() && (framesInFlight == 0 || retiredTextures.front().frameNumber + framesInFlight < frameNumber))
+			{
+				RetiredTexture& retired = retiredTextures.front();
+
+				vkDestroySampler(vkDevice, retired.sampler, nullptr);
+				vkDestroyImageView(vkDevice, retired.imageView, nullptr);
+				vkDestroyImage(vkDevice, retired.image, nullptr);
+				Memory::FreeMemory(vkDevice, retired.imageMemory);
+				textureTable->UnregisterTexture(retired.textureSlot);
+
+				retiringTextureBytes -= retired.bytes;
+				retiredTextures.pop_front();
+			}
+		}
+
+		/*
+		* Initialize Texture Image. KTX2 files and up to date baked .vtex copies are mapped and uploaded as is,
+		*	anything else is decoded with stb_image
+		*/
+		void InitTextureImage(const std::string& texturePath, TextureResource& texture)
+		{
+			Filesystem::MappedFile mappedFile;
+			TextureContainer::Header header;
+
+			if (Ktx2::IsKtx2Path(texturePath))
+			{
+				if (!mappedFile.Open(texturePath) ||
+					!Ktx2::Parse(mappedFile.Data(), mappedFile.Size(), texturePath, header) ||
+					!IsTextureFormatSupported(texturePath, static_cast<VkFormat>(header.format)))
+				{
+					throw std::runtime_error("failed to load KTX2 texture!");
+				}
+
+				InitTextureImageMapped(texturePath, header, mappedFile.Data(), texture);
+				return;
+			}
+
+			std::string bakedPath = TextureContainer::BakedPathFor(texturePath);
+			if (TextureContainer::IsBakeCurrent(texturePath, bakedPath))
+			{
+				if (mappedFile.Open(bakedPath) &&
+					TextureContainer::TryParse(mappedFile.Data(), mappedFile.Size(), bakedPath, header) &&
+					IsTextureFormatSupported(bakedPath, static_cast<VkFormat>(header.format)))
+				{
+					InitTextureImageMapped(bakedPath, header, mappedFile.Data(), texture);
+					return;
+				}
+			}
+			else if (std::filesystem::exists(bakedPath))
+			{
+				SDL_Log("Baked texture %s is older than %s, rebake with --bake-texture", bakedPath.c_str(), texturePath.c_str());
+			}
+
+			InitTextureImageSource(texturePath, texture);
+		}
+
+		/*
+		* BCn needs textureCompressionBC, anything else still has to be sampleable with optimal tiling
+		*/
+		bool IsTextureFormatSupported(const std::string& path, VkFormat format) const
+		{
+			VkFormatProperties formatProperties;
+			vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice, format, &formatProperties);
+
+			bool bSupported = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+			if (TextureCompression::IsBlockCompressed(format))
+			{
+				bSupported = bSupported && bTextureCompressionBC;
+			}
+
+			if (!bSupported)
+			{
+				SDL_Log("Texture %s uses format %d which this device cannot sample", path.c_str(), (int)format);
+			}
+
+			return bSupported;
+		}
+
+		/*
+		* Every level already filtered (and compressed) offline, so the texture can stream: only the levels at or below
+		*	STREAMING_TAIL_SIZE go up now, the finer ones follow as UpdateStreaming sees the texture drawn large enough to need them
+		*/
+		void InitTextureImageMapped(const std::string& path, const TextureContainer::Header& header, const uint8_t* fileData, TextureResource& texture)
+		{
+			texture.format = static_cast<VkFormat>(header.format);
+			texture.bStreamed = true;
+			texture.streamPath = path;
+			texture.streamHeader = header;
+			texture.baseMip = StreamingTailMip(header);
+			texture.residentMip = texture.baseMip;
+			texture.desiredMip = texture.baseMip;
+			texture.mipLevels = header.mipLevels - texture.baseMip;
+
+			CreateStreamedImage(texture.streamHeader, texture.baseMip, texture.format, texture.image, texture.imageMemory);
+			UploadLevels(header, fileData, texture.image, texture.format, texture.baseMip, texture.residentMip, header.mipLevels, true);
+
+			texture.residentBytes = StreamedImageBytes(header, texture.baseMip);
+
+			stagingRing.Submit();
+		}
+
+		/*
+		* First level no larger than STREAMING_TAIL_SIZE, the part of the chain that is always resident
+		*/
+		static uint32_t StreamingTailMip(const TextureContainer::Header& header)
+		{
+			uint32_t tailMip = 0;
+			while (tailMip + 1 < header.mipLevels && std::max(header.levels[tailMip].width, header.levels[tailMip].height) > STREAMING_TAIL_SIZE)
+			{
+				tailMip++;
+			}
+
+			return tailMip;
+		}
+
+		static VkDeviceSize StreamedImageBytes(const TextureContainer::Header& header, uint32_t baseMip)
+		{
+			VkDeviceSize bytes = 0;
+			for (uint32_t i = baseMip; i < header.mipLevels; i++)
+			{
+				bytes += header.levels[i].size;
+			}
+
+			return bytes;
+		}
+
+		/*
+		* Image holding chain levels [baseMip, header.mipLevels), its level 0 is chain level baseMip
+		*/
+		void CreateStreamedImage(const TextureContainer::Header& header, uint32_t baseMip, VkFormat format, VkImage& image, VkDeviceMemory& imageMemory)
+		{
+			Images::CreateImage
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				header.levels[baseMip].width,
+				header.levels[baseMip].height,
+				header.mipLevels - baseMip,
+				VK_SAMPLE_COUNT_1_BIT,
+				format,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, // no blits, so no TRANSFER_SRC
+				MemoryUsage::GpuOnly,
+				image,
+				imageMemory,
+				MemoryCategory::Texture
+			);
+		}
+
+		/*
+		* Copy chain levels [firstLevel, endLevel) from the mapped file into image, whose level 0 is chain level imageBaseMip.
+		*	Levels are copied from the file straight into the staging ring and go up in a single vkCmdCopyBufferToImage.
+		*	bFreshImage transitions every level of a new image, so the ones not filled yet are already in the layout the
+		*	descriptor expects, the sampler's minLod keeps them from being read. Recorded only, the caller submits
+		*/
+		void UploadLevels(const TextureContainer::Header& header, const uint8_t* fileData, VkImage image, VkFormat format, uint32_t imageBaseMip, uint32_t firstLevel, uint32_t endLevel, bool bFreshImage)
+		{
+			// pack the levels back to back, aligned for any texel/block size
+			std::vector<VkBufferImageCopy> regions(endLevel - firstLevel);
+			VkDeviceSize uploadSize = 0;
+			for (uint32_t i = firstLevel; i < endLevel; i++)
+			{
+				VkBufferImageCopy& region = regions[i - firstLevel];
+				region = {};
+				region.bufferOffset = TextureContainer::AlignLevelOffset(uploadSize);
+				region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				region.imageSubresource.mipLevel = i - imageBaseMip;
+				region.imageSubresource.baseArrayLayer = 0;
+				region.imageSubresource.layerCount = 1;
+				region.imageExtent = { header.levels[i].width, header.levels[i].height, 1 };
+
+				uploadSize = region.bufferOffset + header.levels[i].size;
+			}
+
+			if (uploadSize > stagingRing.GetCapacity())
+			{
+				UploadLevelsOversized(header, fileData, image, format, imageBaseMip, firstLevel, endLevel, bFreshImage, regions, uploadSize);
+				return;
+			}
+
+			VkDeviceSize stagingOffset;
+			uint8_t* stagingData = static_cast<uint8_t*>(stagingRing.Allocate(uploadSize, TextureContainer::LevelAlignment, stagingOffset));
+			for (uint32_t i = firstLevel; i < endLevel; i++)
+			{
+				VkBufferImageCopy& region = regions[i - firstLevel];
+				Parallel::Copy(stagingData + region.bufferOffset, fileData + header.levels[i].offset, static_cast<size_t>(header.levels[i].size));
+				region.bufferOffset += stagingOffset;
+			}
+
+			// queue order plus the final barrier keep any later draw from sampling before the copy lands, nothing waits here
+			VkCommandBuffer commandBuffer = stagingRing.GetCommandBuffer();
+			RecordLevelUpload(commandBuffer, stagingRing.GetBuffer(), regions, header, image, format, imageBaseMip, firstLevel, endLevel, bFreshImage);
+		}
+
+		/*
+		* Uploads bigger than the whole ring get a staging buffer of their own
+		*/
+		void UploadLevelsOversized(const TextureContainer::Header& header, const uint8_t* fileData, VkImage image, VkFormat format, uint32_t imageBaseMip, uint32_t firstLevel, uint32_t endLevel, bool bFreshImage, const std::vector<VkBufferImageCopy>& regions, VkDeviceSize uploadSize)
+		{
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				uploadSize,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				MemoryUsage::Upload,
+				stagingBuffer,
+				stagingBufferMemory,
+				MemoryCategory::Staging
+			);
+
+			void* data;
+			vkMapMemory(vkDevice, stagingBufferMemory, 0, uploadSize, 0, &data);
+			for (uint32_t i = firstLevel; i < endLevel; i++)
+			{
+				Parallel::Copy(static_cast<uint8_t*>(data) + regions[i - firstLevel].bufferOffset, fileData + header.levels[i].offset, static_cast<size_t>(header.levels[i].size));
+			}
+			vkUnmapMemory(vkDevice, stagingBufferMemory);
+
+			VkCommandBuffer commandBuffer = Images::BeginOneTimeCommands(vkDevice, commandPool);
+			RecordLevelUpload(commandBuffer, stagingBuffer, regions, header, image, format, imageBaseMip, firstLevel, endLevel, bFreshImage);
+			Images::EndOneTimeCommands(vkDevice, graphicsQueue, commandPool, commandBuffer);
+
+			// Cleanup
+			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, stagingBufferMemory);
+		}
+
+		static void RecordLevelUpload(VkCommandBuffer commandBuffer, VkBuffer stagingBuffer, const std::vector<VkBufferImageCopy>& regions, const TextureContainer::Header& header, VkImage image, VkFormat format, uint32_t imageBaseMip, uint32_t firstLevel, uint32_t endLevel, bool bFreshImage)
+		{
+			// a fresh image moves as a whole, otherwise only the levels being filled, whatever they held is discarded
+			uint32_t barrierBaseLevel = bFreshImage ? 0 : firstLevel - imageBaseMip;
+			uint32_t barrierLevelCount = bFreshImage ? header.mipLevels - imageBaseMip : endLevel - firstLevel;
+
+			Images::RecordLayoutTransition(commandBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, barrierLevelCount, barrierBaseLevel);
+			vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+			Images::RecordLayoutTransition(commandBuffer, image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, barrierLevelCount, barrierBaseLevel);
+		}
+
+		/*
+		* Decode the source image and build its mips on the GPU, for textures that have not been baked.
+		*	The decoder writes its output straight into the staging ring, so there is no heap copy of the pixels
+		*/
+		void InitTextureImageSource(const std::string& texturePath, TextureResource& texture)
+		{
+			int texWidth, texHeight, texChannels;
+			if (!stbi_info(texturePath.c_str(), &texWidth, &texHeight, &texChannels))
+			{
+				throw std::runtime_error("failed to load texture image!");
+			}
+
+			VkDeviceSize imageSize = static_cast<VkDeviceSize>(texWidth) * texHeight * 4;
+			if (imageSize + StagingDecode::Slack > stagingRing.GetCapacity())
+			{
+				InitTextureImageSourceOversized(texturePath, texture);
+				return;
+			}
+
+			VkDeviceSize stagingOffset;
+			void* stagingData = stagingRing.Allocate(imageSize + StagingDecode::Slack, TextureContainer::LevelAlignment, stagingOffset);
+			{
+				StagingDecode::ScopedTarget decodeTarget(stagingData, static_cast<size_t>(imageSize));
+
+				stbi_uc* pixels = stbi_load(texturePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+				if (!pixels)
+				{
+					throw std::runtime_error("failed to load texture image!");
+				}
+
+				if (pixels != stagingData)
+				{
+					Parallel::Copy(stagingData, pixels, static_cast<size_t>(imageSize));
+				}
+				stbi_image_free(pixels); // no-op when it decoded in place
+			}
+
+			texture.mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+
+			Images::CreateImage
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				texWidth,
+				texHeight,
+				texture.mipLevels,
+				VK_SAMPLE_COUNT_1_BIT,
+				VK_FORMAT_R8G8B8A8_SRGB,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				MemoryUsage::GpuOnly,
+				texture.image,
+				texture.imageMemory,
+				MemoryCategory::Texture
+			);
+
+			VkBufferImageCopy bufferImageCopyRegion{};
+			bufferImageCopyRegion.bufferOffset = stagingOffset;
+			bufferImageCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			bufferImageCopyRegion.imageSubresource.mipLevel = 0;
+			bufferImageCopyRegion.imageSubresource.baseArrayLayer = 0;
+			bufferImageCopyRegion.imageSubresource.layerCount = 1;
+			bufferImageCopyRegion.imageExtent = { static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 1 };
+
+			VkCommandBuffer commandBuffer = stagingRing.GetCommandBuffer();
+			Images::RecordLayoutTransition(commandBuffer, texture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.mipLevels);
+			vkCmdCopyBufferToImage(commandBuffer, stagingRing.GetBuffer(), texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopyRegion);
+			stagingRing.Submit();
+
+			// same queue, so the blits are ordered after the copy above.
+			//	transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
+			Images::GenerateMipmaps
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				graphicsQueue,
+				commandPool,
+				texture.image,
+				VK_FORMAT_R8G8B8A8_SRGB,
+				texWidth,
+				texHeight,
+				texture.mipLevels
+			);
+		}
+
+		/*
+		* Images bigger than the whole ring are decoded to the heap and staged through a buffer of their own
+		*/
+		void InitTextureImageSourceOversized(const std::string& texturePath, TextureResource& texture)
+		{
+			int texWidth, texHeight, texChannels;
+			stbi_uc* pixels = stbi_load(texturePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+			VkDeviceSize imageSize = static_cast<VkDeviceSize>(texWidth) * texHeight * 4;
+
+			if (!pixels)
+			{
+				throw std::runtime_error("failed to load texture image!");
+			}
+
+			texture.mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				imageSize,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				MemoryUsage::Upload,
+				stagingBuffer,
+				stagingBufferMemory,
+				MemoryCategory::Staging
+			);
+
+			void* data;
+			vkMapMemory(vkDevice, stagingBufferMemory, 0, imageSize, 0, &data);
+			Parallel::Copy(data, pixels, static_cast<size_t>(imageSize));
+			vkUnmapMemory(vkDevice, stagingBufferMemory);
+
+			stbi_image_free(pixels);
+
+			Images::CreateImage
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				texWidth,
+				texHeight,
+				texture.mipLevels,
+				VK_SAMPLE_COUNT_1_BIT,
+				VK_FORMAT_R8G8B8A8_SRGB,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				MemoryUsage::GpuOnly,
+				texture.image,
+				texture.imageMemory,
+				MemoryCategory::Texture
+			);
+
+			Images::TransitionImageLayout
+			(
+				vkDevice,
+				graphicsQueue,
+				commandPool,
+				texture.image,
+				VK_FORMAT_R8G8B8A8_SRGB,
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				texture.mipLevels
+			);
+
+			//transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
+
+			Images::CopyBufferToImage
+			(
+				vkDevice,
+				graphicsQueue,
+				commandPool,
+				stagingBuffer,
+				texture.image,
+				static_cast<uint32_t>(texWidth),
+				static_cast<uint32_t>(texHeight)
+			);
+
+			// Cleanup
+			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, stagingBufferMemory);
+
+			Images::GenerateMipmaps
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				graphicsQueue,
+				commandPool,
+				texture.image,
+				VK_FORMAT_R8G8B8A8_SRGB,
+				texWidth,
+				texHeight,
+				texture.mipLevels
+			);
+		}
+
+		/*
+		* Initialize Texture Image View
+		*/
+		void InitTextureImageView(TextureResource& texture)
+		{
+			texture.imageView = Images::CreateImageView(vkDevice, texture.image, texture.format, VK_IMAGE_ASPECT_COLOR_BIT, texture.mipLevels);
+		}
+
+		/*
+		* Initialize Texture Sampler
+		*/
+		void InitTextureSampler(TextureResource& texture)
+		{
+			VkSamplerCreateInfo createInfoSampler{};
+			createInfoSampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			createInfoSampler.magFilter = VK_FILTER_LINEAR;
+			createInfoSampler.minFilter = VK_FILTER_LINEAR;
+			createInfoSampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+			createInfoSampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+			createInfoSampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+
+			// TODO[CC] - remove this and just collect during engine init and use dependancy injection to put query them here
+			VkPhysicalDeviceProperties physicalDeviceProperties{};
+			vkGetPhysicalDeviceProperties(vkPhysicalDevice, &physicalDeviceProperties);
+
+			createInfoSampler.anisotropyEnable = VK_TRUE;
+			createInfoSampler.maxAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
+
+			// Can choose to ignore filtering in the sampler
+			//createInfoSampler.anisotropyEnable = VK_FALSE;
+			//createInfoSampler.maxAnisotropy = 1.0f;
+
+			createInfoSampler.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+			// sample in the range of [0, 1)
+			createInfoSampler.unnormalizedCoordinates = VK_FALSE;
+
+			createInfoSampler.compareEnable = VK_FALSE; // mainly used for percentage-closer filtering on shadow maps
+			createInfoSampler.compareOp = VK_COMPARE_OP_ALWAYS;
+
+			createInfoSampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+			createInfoSampler.mipLodBias = 0.0f;
+			createInfoSampler.minLod = static_cast<float>(texture.residentMip - texture.baseMip); // streamed levels not uploaded yet
+			createInfoSampler.maxLod = static_cast<float>(texture.mipLevels);
+
+
+			if (vkCreateSampler(vkDevice, &createInfoSampler, nullptr, &texture.sampler) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Failed to create texture sampler!");
+			}
+		}
+
+		/*
+		* Register texture view and sampler into the bindless texture table
+		*/
+		void InitTextureSlot(TextureResource& texture)
+		{
+			texture.textureSlot = textureTable->RegisterTexture(vkDevice, texture.imageView, texture.sampler);
+		}
+
+		/*
+		* Bounding sphere around the box of the vertices, loose but cheap
+		*/
+		static void ComputeMeshBounds(const std::vector<Vertex>& vertices, MeshResource& mesh)
+		{
+			if (vertices.empty())
+			{
+				return;
+			}
+
+			glm::vec3 minimum = vertices[0].pos;
+			glm::vec3 maximum = vertices[0].pos;
+			for (const Vertex& vertex : vertices)
+			{
+				minimum = glm::min(minimum, vertex.pos);
+				maximum = glm::max(maximum, vertex.pos);
+			}
+
+			mesh.boundsCenter = (minimum + maximum) * 0.5f;
+			mesh.boundsRadius = glm::length(maximum - minimum) * 0.5f;
+		}
+
+		/*
+		* Load model
+		*/
+		static void LoadModel(const std::string& modelPath, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			tinyobj::attrib_t attrib;
+			std::vector<tinyobj::shape_t> shapes;
+			std::vector<tinyobj::material_t> materials;
+
+			std::string warn, err;
+			if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, modelPath.c_str()))
+			{
+				throw std::runtime_error(warn + err);
+			}
+
+			// combined indices/vertex map to filter non-unique verts
+			std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+
+			for (const auto& shape : shapes)
+			{
+				for (const auto& index : shape.mesh.indices)
+				{
+					Vertex vertex{};
+
+					vertex.pos = 
+					{
+						attrib.vertices[3 * index.vertex_index + 0],
+						attrib.vertices[3 * index.vertex_index + 1],
+						attrib.vertices[3 * index.vertex_index + 2]
+					};
+
+					// centered
+					//vertex.texCoord = 
+					//{
+					//	attrib.texcoords[2 * index.texcoord_index + 0],
+					//	attrib.texcoords[2 * index.texcoord_index + 1]
+					//};
+
+					// offset to account for the model
+					vertex.texCoord = 
+					{
+						attrib.texcoords[2 * index.texcoord_index + 0],
+						1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+					};
+
+					vertex.color = { 1.0f, 1.0f, 1.0f };
+
+					if (uniqueVertices.count(vertex) == 0)
+					{
+						uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+						vertices.push_back(vertex);
+					}
+
+					indices.push_back(uniqueVertices[vertex]);
+				}
+			}
+		}
+
+		/*
+		* Initialize Vertex Buffer
+		*/
+		void InitVertexBuffer(const std::vector<Vertex>& vertices, MeshResource& mesh)
+		{
+			VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+
+			// Staging buffer which can have data accessable via CPU
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+			Memory::CreateBuffer(
+				vkDevice,
+				vkPhysicalDevice,
+				bufferSize,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				MemoryUsage::Upload,
+				stagingBuffer,
+				stagingBufferMemory,
+				MemoryCategory::Staging
+			);
+
+			// MAP BUFFER MEMORY
+
+			/*
+			* Unfortunately the driver may not immediately copy the data into the buffer memory,
+			*	for example because of caching. It is also possible that writes to the buffer are not
+			*	visible in the mapped memory yet. There are two ways to deal with that problem:
+			*
+			*		- Use a memory heap that is host coherent, indicated with VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+			*		- Call vkFlushMappedMemoryRanges after writing to the mapped memory,
+			*			and call vkInvalidateMappedMemoryRanges before reading from the mapped memory
+			*
+			* Chosen approach below uses first method (MemoryUsage::Upload is always coherent), the staging ring uses the second
+			*/
+			void* bufferData;
+			vkMapMemory(vkDevice, stagingBufferMemory, 0, bufferSize, 0, &bufferData);
+			memcpy(bufferData, vertices.data(), (size_t)bufferSize);
+			vkUnmapMemory(vkDevice, stagingBufferMemory);
+
+			// Vertex buffer where its memory is GPU only and updated via the staging buffer
+			Memory::CreateBuffer(
+				vkDevice,
+				vkPhysicalDevice,
+				bufferSize,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+				MemoryUsage::GpuOnly,
+				mesh.vertexBuffer,
+				mesh.vertexBufferMemory,
+				MemoryCategory::Geometry
+			);
+
+			// transfer from staging over to gpu vertex buffer
+			Images::CopyBuffer(vkDevice, graphicsQueue, commandPool, stagingBuffer, mesh.vertexBuffer, bufferSize);
+
+			// cleanup staging buffer
+			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, stagingBufferMemory);
+		}
+
+		/*
+		* Initialize Index Buffer
+		*/
+		void InitIndexBuffer(const std::vector<uint32_t>& indices, MeshResource& mesh)
+		{
+			VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
+
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				bufferSize,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				MemoryUsage::Upload,
+				stagingBuffer,
+				stagingBufferMemory,
+				MemoryCategory::Staging
+			);
+
+			void* data;
+			vkMapMemory(vkDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
+			memcpy(data, indices.data(), (size_t)bufferSize);
+			vkUnmapMemory(vkDevice, stagingBufferMemory);
+
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				bufferSize,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+				MemoryUsage::GpuOnly,
+				mesh.indexBuffer,
+				mesh.indexBufferMemory,
+				MemoryCategory::Geometry
+			);
+
+			Images::CopyBuffer(vkDevice, graphicsQueue, commandPool, stagingBuffer, mesh.indexBuffer, bufferSize);
+
+			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
+			Memory::FreeMemory(vkDevice, stagingBufferMemory);
+		}
+
+	private:
+		VkDevice vkDevice;
+		VkPhysicalDevice vkPhysicalDevice;
+
+		VkQueue graphicsQueue;
+		VkCommandPool commandPool;
+
+		BindlessTextureTable* textureTable;
+
+		bool bTextureCompressionBC;
+
+		// Baked/KTX2 texture uploads, reclaimed as their submissions retire
+		static constexpr VkDeviceSize STAGING_RING_SIZE = 64ull * 1024 * 1024;
+		StagingRing stagingRing;
+
+		// Mip streaming, levels at or below the tail size load with the texture, finer ones on demand
+		static constexpr uint32_t STREAMING_TAIL_SIZE = 128;
+		static constexpr VkDeviceSize STREAMING_BYTES_PER_FRAME = 16ull * 1024 * 1024;
+
+		struct RetiredTexture
+		{
+			uint64_t frameNumber;
+			VkImage image;
+			VkDeviceMemory imageMemory;
+			VkImageView imageView;
+			VkSampler sampler;
+			VkDeviceSize bytes;
+			uint32_t textureSlot;
+		};
+
+		uint64_t frameNumber;
+		VkDeviceSize retiringTextureBytes; // retired images still waiting on the GPU
+		std::deque<RetiredTexture> retiredTextures;
+
+		/* !! NOTE !!
+		* the memory type that allows us to access it from the CPU may not be the most optimal memory type for the graphics card
+		*	to read from. The most optimal memory has the VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT flag and is usually not accessible
+		*	by the CPU on dedicated graphics cards. In this chapter we're going to create two vertex buffers.
+		*	One staging buffer in CPU accessible memory to upload the data from the vertex array to, and the final vertex buffer
+		*	in device local memory. We'll then use a buffer copy command to move the data from the staging buffer to the actual
+		*	vertex buffer.
+		*/
+		ResourcePool<MeshTag, MeshResource> meshes;
+		ResourcePool<TextureTag, TextureResource> textures;
+	};
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "VDefinitions.h"
+
+#if VIGOR_RUNTIME_SHADER_COMPILATION
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <sstream>
+#include <utility>
+#include <cinttypes>
+#include <filesystem>
+
+#include <SDL.h>
+
+#include <shaderc/shaderc.hpp>
+
+#include "VFilesystem.h"
+
+#if defined(_MSC_VER)
+#pragma comment(lib, "shaderc_combined.lib") // ships with the Vulkan SDK
+#endif
+
+namespace Vigor
+{
+	/*
+	* Development mode GLSL -> SPIR-V compiler, editing a shader only needs a relaunch instead of running shadercompile.
+	*
+	* Output is cached on disk under a 64-bit FNV-1a hash of the source, every file it includes and the defines,
+	*	an unchanged shader is read back from the cache without touching the compiler.
+	*/
+	class ShaderCompiler
+	{
+	public:
+		using Defines = std::vector<std::pair<std::string, std::string>>;
+
+		void Init(const std::string& _sourceRoot, const std::string& _cacheDirectory)
+		{
+			sourceRoot = _sourceRoot;
+			cacheDirectory = _cacheDirectory;
+		}
+
+		/*
+		* SPIR-V for the GLSL file called name (e.g. "shader.frag") anywhere under the source root.
+		*	False if the source can't be found or fails to compile, errors are logged so callers can fall back
+		*/
+		bool Compile(const std::string& name, std::vector<uint32_t>& outSpirv, const Defines& defines = {})
+		{
+			std::filesystem::path sourcePath;
+			shaderc_shader_kind shaderKind;
+			if (!FindSource(name, sourcePath) || !GetShaderKind(sourcePath, shaderKind))
+			{
+				return false;
+			}
+
+			uint64_t hash = HashFnv1a(&CACHE_VERSION, sizeof(CACHE_VERSION));
+			std::set<std::filesystem::path> visitedFiles;
+			if (!HashSourceTree(sourcePath, hash, visitedFiles))
+			{
+				SDL_Log("Failed to read shader source %s", sourcePath.string().c_str());
+				return false;
+			}
+
+			for (const auto& [defineName, defineValue] : defines)
+			{
+				hash = HashFnv1a(defineName.data(), defineName.size() + 1, hash); // include the terminator so "AB"+"C" != "A"+"BC"
+				hash = HashFnv1a(defineValue.data(), defineValue.size() + 1, hash);
+			}
+
+			char hashString[17];
+			snprintf(hashString, sizeof(hashString), "%016" PRIx64, hash);
+			std::string cachePath = cacheDirectory + "/" + name + "." + hashString + ".spv";
+
+			std::vector<char> cachedSpirv;
+			if (Filesystem::TryRead(cachePath, cachedSpirv) && !cachedSpirv.empty() && cachedSpirv.size() % sizeof(uint32_t) == 0)
+			{
+				outSpirv.resize(cachedSpirv.size() / sizeof(uint32_t));
+				memcpy(outSpirv.data(), cachedSpirv.data(), cachedSpirv.size());
+				return true;
+			}
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			std::vector<char> source;
+			Filesystem::TryRead(sourcePath.string(), source);
+
+			shaderc::CompileOptions compileOptions;
+			compileOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+			compileOptions.SetOptimizationLevel(shaderc_optimization_level_performance);
+			compileOptions.SetIncluder(std::make_unique<Includer>());
+			for (const auto& [defineName, defineValue] : defines)
+			{
+				compileOptions.AddMacroDefinition(defineName, defineValue);
+			}
+
+			shaderc::SpvCompilationResult compilationResult;
+			{
+				// shaderc::Compiler is not safe to share between threads
+				std::lock_guard<std::mutex> lock(compilerMutex);
+				compilationResult = compiler.CompileGlslToSpv(source.data(), source.size(), shaderKind, sourcePath.string().c_str(), compileOptions);
+			}
+
+			if (compilationResult.GetCompilationStatus() != shaderc_compilation_status_success)
+			{
+				SDL_Log("Failed to compile %s:\n%s", name.c_str(), compilationResult.GetErrorMessage().c_str());
+				return false;
+			}
+
+			outSpirv.assign(compilationResult.cbegin(), compilationResult.cend());
+
+			double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+			SDL_Log("Compiled %s in %.2f ms", name.c_str(), elapsedMs);
+
+			if (!Filesystem::WriteAtomic(cachePath, outSpirv.data(), outSpirv.size() * sizeof(uint32_t)))
+			{
+				SDL_Log("Failed to write SPIR-V cache to %s", cachePath.c_str());
+			}
+
+			return true;
+		}
+
+	private:
+		/*
+		* Resolves #include "file" relative to the including file, the same rule HashSourceTree follows
+		*/
+		class Includer : public shaderc::CompileOptions::IncluderInterface
+		{
+		public:
+			shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t includeDepth) override
+			{
+				IncludeData* includeData = new IncludeData();
+				includeData->path = (std::filesystem::path(requestingSource).parent_path() / requestedSource).string();
+
+				if (!Filesystem::TryRead(includeData->path, includeData->content))
+				{
+					// an empty source name tells shaderc the include failed, the content becomes the error message
+					std::string errorMessage = "Cannot open include " + includeData->path;
+					includeData->content.assign(errorMessage.begin(), errorMessage.end());
+					includeData->path.clear();
+				}
+
+				includeData->result.source_name = includeData->path.c_str();
+				includeData->result.source_name_length = includeData->path.size();
+				includeData->result.content = includeData->content.data();
+				includeData->result.content_length = includeData->content.size();
+				includeData->result.user_data = includeData;
+
+				return &includeData->result;
+			}
+
+			void ReleaseInclude(shaderc_include_result* data) override
+			{
+				delete static_cast<IncludeData*>(data->user_data);
+			}
+
+		private:
+			struct IncludeData
+			{
+				shaderc_include_result result{};
+				std::string path;
+				std::vector<char> content;
+			};
+		};
+
+		bool FindSource(const std::string& name, std::filesystem::path& outSourcePath)
+		{
+			std::lock_guard<std::mutex> lock(sourcePathsMutex);
+
+			auto itSourcePath = sourcePaths.find(name);
+			if (itSourcePath != sourcePaths.end())
+			{
+				outSourcePath = itSourcePath->second;
+				return true;
+			}
+
+			std::error_code errorCode;
+			for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(sourceRoot, errorCode))
+			{
+				if (entry.is_regular_file() && entry.path().filename() == name)
+				{
+					outSourcePath = entry.path();
+					sourcePaths.emplace(name, outSourcePath);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		static bool GetShaderKind(const std::filesystem::path& sourcePath, shaderc_shader_kind& outShaderKind)
+		{
+			std::string extension = sourcePath.extension().string();
+			if (extension == ".vert")
+			{
+				outShaderKind = shaderc_vertex_shader;
+			}
+			else if (extension == ".frag")
+			{
+				outShaderKind = shaderc_fragment_shader;
+			}
+			else if (extension == ".comp")
+			{
+				outShaderKind = shaderc_compute_shader;
+			}
+			else
+			{
+				SDL_Log("Unknown shader stage for %s", sourcePath.string().c_str());
+				return false;
+			}
+
+			return true;
+		}
+
+		/*
+		* Hash a source file and, recursively, every file it #includes so editing a header invalidates its users
+		*/
+		static bool HashSourceTree(const std::filesystem::path& sourcePath, uint64_t& hash, std::set<std::filesystem::path>& visitedFiles)
+		{
+			if (!visitedFiles.insert(sourcePath.lexically_normal()).second)
+			{
+				return true; // include guards make repeats a no-op for the compiler too
+			}
+
+			std::vector<char> source;
+			if (!Filesystem::TryRead(sourcePath.string(), source))
+			{
+				return false;
+			}
+
+			hash = HashFnv1a(source.data(), source.size(), hash);
+
+			std::istringstream stream(std::string(source.begin(), source.end()));
+			std::string line;
+			while (std::getline(stream, line))
+			{
+				size_t includePos = line.find("#include");
+				size_t openQuote = line.find('"', includePos);
+				size_t closeQuote = line.find('"', openQuote + 1);
+				if (includePos == std::string::npos || openQuote == std::string::npos || closeQuote == std::string::npos)
+				{
+					continue;
+				}
+
+				std::filesystem::path includePath = sourcePath.parent_path() / line.substr(openQuote + 1, closeQuote - openQuote - 1);
+				if (!HashSourceTree(includePath, hash, visitedFiles))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		static uint64_t HashFnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+	private:
+		// bump when compile options change so stale SPIR-V is never picked up
+		static constexpr uint32_t CACHE_VERSION = 1;
+
+		std::string sourceRoot;
+		std::string cacheDirectory;
+
+		std::mutex compilerMutex;
+		shaderc::Compiler compiler;
+
+		std::mutex sourcePathsMutex;
+		std::map<std::string, std::filesystem::path> sourcePaths;
+	};
+}
+
+#endif // VIGOR_RUNTIME_SHADER_COMPILATION
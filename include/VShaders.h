@@ -1,30 +1,47 @@
 #pragma once
 
 #include <vector>
+#include <cstring>
 
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_core.h>
 
+#include "VErrors.h"
+
 namespace Vigor
 {
 	namespace Shaders
 	{
-        static VkShaderModule CreateShaderModule(const std::vector<char>& code, VkDevice vkDevice)
+        /*
+        * Create a module straight from SPIR-V words, e.g. the arrays in VEmbeddedShaders.h
+        */
+        static VkShaderModule CreateShaderModule(const uint32_t* code, size_t wordCount, VkDevice vkDevice)
         {
             VkShaderModuleCreateInfo shaderModuleCreateInfo{};
             shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-            shaderModuleCreateInfo.codeSize = code.size();
-            shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(code.data()); // TODO - get rid of this reinterpret_cast when possible, its BAD
+            shaderModuleCreateInfo.codeSize = wordCount * sizeof(uint32_t); // in bytes
+            shaderModuleCreateInfo.pCode = code;
 
             VkShaderModule shaderModule;
 
             VkResult createShaderModuleRes = vkCreateShaderModule(vkDevice, &shaderModuleCreateInfo, nullptr, &shaderModule);
             if (createShaderModuleRes != VK_SUCCESS)
             {
-                std::string errorMsg = std::format("Failed to create shader module Error: {}\n\n", (int)createShaderModuleRes);
+                Vigor::Errors::RaiseRuntimeError("Failed to create shader module Error: {}\n\n", (int)createShaderModuleRes);
             }
 
             return shaderModule;
         }
+
+        /*
+        * Create a module from a .spv file's bytes, copied into words as char buffers carry no alignment guarantee
+        */
+        static VkShaderModule CreateShaderModule(const std::vector<char>& code, VkDevice vkDevice)
+        {
+            std::vector<uint32_t> words((code.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+            memcpy(words.data(), code.data(), code.size());
+
+            return CreateShaderModule(words.data(), words.size(), vkDevice);
+        }
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <algorithm>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VErrors.h"
+#include "VMemory.h"
+
+namespace Vigor
+{
+	/*
+	* Persistently mapped upload buffer used as a ring.
+	*
+	* Allocations are written in place and copied by a command buffer the ring records, submitted with a fence instead of
+	*	idling the queue. Space is only reclaimed once the submission that read it has retired, so uploads keep flowing while
+	*	earlier ones are still in flight. Offsets are tracked as ever increasing byte counts, the physical offset is taken
+	*	modulo the capacity and an allocation that would straddle the end starts again at zero.
+	*/
+	class StagingRing
+	{
+	public:
+		StagingRing()
+			: vkDevice(VK_NULL_HANDLE)
+			, queue(VK_NULL_HANDLE)
+			, commandPool(VK_NULL_HANDLE)
+			, buffer(VK_NULL_HANDLE)
+			, bufferMemory(VK_NULL_HANDLE)
+			, mappedData(nullptr)
+			, capacity(0)
+			, head(0)
+			, tail(0)
+			, flushedHead(0)
+			, bCoherent(true)
+			, recordingCommandBuffer(VK_NULL_HANDLE)
+		{
+
+		}
+
+		void Init(VkDevice _vkDevice, VkPhysicalDevice vkPhysicalDevice, VkQueue _queue, VkCommandPool _commandPool, VkDeviceSize _capacity)
+		{
+			vkDevice = _vkDevice;
+			queue = _queue;
+			commandPool = _commandPool;
+			capacity = _capacity;
+
+			// HOST_CACHED when there is one, stb_image reads back the previous row while unfiltering PNGs decoded in place
+			Memory::CreateBuffer
+			(
+				vkDevice,
+				vkPhysicalDevice,
+				capacity,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				MemoryUsage::Readback,
+				buffer,
+				bufferMemory,
+				MemoryCategory::Staging
+			);
+
+			vkMapMemory(vkDevice, bufferMemory, 0, capacity, 0, &mappedData);
+
+			// cached memory is often not coherent, writes are then flushed once per submitted batch
+			bCoherent = (Memory::Budget().GetPropertyFlags(bufferMemory) & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+		}
+
+		/*
+		* Reserve size bytes and return where to write them, outOffset is the matching offset into GetBuffer().
+		*	Blocks on the oldest submissions when the ring is full, and may submit the batch being recorded, so call it
+		*	before GetCommandBuffer() for the commands that consume the allocation
+		*/
+		void* Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset)
+		{
+			if (size > capacity)
+			{
+				throw std::runtime_error("Staging ring allocation is larger than the ring!");
+			}
+
+			for (;;)
+			{
+				if (head == tail) // nothing live, start from the top rather than wrapping
+				{
+					head = 0;
+					tail = 0;
+					flushedHead = 0;
+				}
+
+				VkDeviceSize physical = head % capacity;
+				VkDeviceSize aligned = (physical + alignment - 1) & ~(alignment - 1);
+
+				VkDeviceSize start = head + (aligned - physical);
+				if (aligned + size > capacity)
+				{
+					start = head + (capacity - physical); // next lap, offset 0
+				}
+
+				VkDeviceSize end = start + size;
+				if (end - tail <= capacity)
+				{
+					head = end;
+					outOffset = start % capacity;
+					return static_cast<char*>(mappedData) + outOffset;
+				}
+
+				// Out of space, hand the current batch to the GPU and wait for the oldest to give some back
+				Submit();
+				if (inFlight.empty())
+				{
+					throw std::runtime_error("Staging ring is full of allocations that were never submitted!");
+				}
+				RetireOldest();
+			}
+		}
+
+		/*
+		* The batch being recorded, begun on first use
+		*/
+		VkCommandBuffer GetCommandBuffer()
+		{
+			if (recordingCommandBuffer == VK_NULL_HANDLE)
+			{
+				VkCommandBufferAllocateInfo allocInfoCommandBuffer{};
+				allocInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+				allocInfoCommandBuffer.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+				allocInfoCommandBuffer.commandPool = commandPool;
+				allocInfoCommandBuffer.commandBufferCount = 1;
+
+				vkAllocateCommandBuffers(vkDevice, &allocInfoCommandBuffer, &recordingCommandBuffer);
+
+				VkCommandBufferBeginInfo beginInfoCommandBuffer{};
+				beginInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+				beginInfoCommandBuffer.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+				vkBeginCommandBuffer(recordingCommandBuffer, &beginInfoCommandBuffer);
+			}
+
+			return recordingCommandBuffer;
+		}
+
+		/*
+		* Submit the recorded batch, the allocations it copies from are reclaimed once its fence signals
+		*/
+		void Submit()
+		{
+			if (recordingCommandBuffer == VK_NULL_HANDLE)
+			{
+				return;
+			}
+
+			vkEndCommandBuffer(recordingCommandBuffer);
+			FlushWritten();
+
+			VkFenceCreateInfo createInfoFence{};
+			createInfoFence.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+			Submission submission{};
+			submission.commandBuffer = recordingCommandBuffer;
+			submission.end = head;
+			vkCreateFence(vkDevice, &createInfoFence, nullptr, &submission.fence);
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &submission.commandBuffer;
+
+			VkResult queueSubmitRes = vkQueueSubmit(queue, 1, &submitInfo, submission.fence);
+			if (queueSubmitRes != VK_SUCCESS)
+			{
+				Vigor::Errors::RaiseRuntimeError("Failed to submit staging upload Error: {}\n\n", (int)queueSubmitRes);
+			}
+
+			inFlight.push_back(submission);
+			recordingCommandBuffer = VK_NULL_HANDLE;
+
+			// opportunistically give back whatever has already finished
+			while (!inFlight.empty() && vkGetFenceStatus(vkDevice, inFlight.front().fence) == VK_SUCCESS)
+			{
+				RetireOldest();
+			}
+		}
+
+		/*
+		* Submit anything pending and wait for every upload to land
+		*/
+		void Flush()
+		{
+			Submit();
+			while (!inFlight.empty())
+			{
+				RetireOldest();
+			}
+		}
+
+		void Shutdown()
+		{
+			Flush();
+
+			vkUnmapMemory(vkDevice, bufferMemory);
+			vkDestroyBuffer(vkDevice, buffer, nullptr);
+			Memory::FreeMemory(vkDevice, bufferMemory);
+
+			mappedData = nullptr;
+			buffer = VK_NULL_HANDLE;
+			bufferMemory = VK_NULL_HANDLE;
+		}
+
+		VkBuffer GetBuffer() const
+		{
+			return buffer;
+		}
+
+		VkDeviceSize GetCapacity() const
+		{
+			return capacity;
+		}
+
+	private:
+		/*
+		* Make everything allocated since the last submit visible to the GPU, one vkFlushMappedMemoryRanges for the whole
+		*	batch. Nothing to do on coherent memory
+		*/
+		void FlushWritten()
+		{
+			if (bCoherent || flushedHead == head)
+			{
+				flushedHead = head;
+				return;
+			}
+
+			VkDeviceSize atomSize = std::max<VkDeviceSize>(Memory::Budget().GetNonCoherentAtomSize(), 1);
+			VkDeviceSize begin = flushedHead % capacity;
+			VkDeviceSize size = head - flushedHead;
+
+			// at most two ranges, the batch may run past the end of the ring and carry on from the top
+			std::array<VkMappedMemoryRange, 2> ranges{};
+			uint32_t rangeCount = 0;
+			auto addRange = [&](VkDeviceSize offset, VkDeviceSize end)
+				{
+					VkMappedMemoryRange& range = ranges[rangeCount++];
+					range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+					range.memory = bufferMemory;
+					range.offset = offset - offset % atomSize;
+
+					VkDeviceSize alignedEnd = (end + atomSize - 1) / atomSize * atomSize;
+					range.size = alignedEnd >= capacity ? VK_WHOLE_SIZE : alignedEnd - range.offset; // the mapping ends at capacity
+				};
+
+			if (size >= capacity)
+			{
+				addRange(0, capacity);
+			}
+			else if (begin + size <= capacity)
+			{
+				addRange(begin, begin + size);
+			}
+			else
+			{
+				addRange(begin, capacity);
+				addRange(0, begin + size - capacity);
+			}
+
+			vkFlushMappedMemoryRanges(vkDevice, rangeCount, ranges.data());
+			flushedHead = head;
+		}
+
+		void RetireOldest()
+		{
+			if (inFlight.empty())
+			{
+				return;
+			}
+
+			Submission& submission = inFlight.front();
+			vkWaitForFences(vkDevice, 1, &submission.fence, VK_TRUE, UINT64_MAX);
+
+			vkDestroyFence(vkDevice, submission.fence, nullptr);
+			vkFreeCommandBuffers(vkDevice, commandPool, 1, &submission.commandBuffer);
+
+			tail = submission.end;
+			inFlight.pop_front();
+		}
+
+	private:
+		struct Submission
+		{
+			VkFence fence;
+			VkCommandBuffer commandBuffer;
+			VkDeviceSize end; // head when submitted, everything before it is free once the fence signals
+		};
+
+		VkDevice vkDevice;
+		VkQueue queue;
+		VkCommandPool commandPool;
+
+		VkBuffer buffer;
+		VkDeviceMemory bufferMemory;
+		void* mappedData;
+
+		VkDeviceSize capacity;
+		VkDeviceSize head; // next free byte, monotonic
+		VkDeviceSize tail; // oldest byte still in use, monotonic
+		VkDeviceSize flushedHead; // head at the last flush, monotonic
+		bool bCoherent;
+
+		VkCommandBuffer recordingCommandBuffer;
+		std::deque<Submission> inFlight;
+	};
+}
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <SDL.h>
+
+#include <stb_image.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VTextureContainer.h"
+#include "VTextureCompression.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VIGOR_TEXTURE_BAKER_SSE2 1
+#include <emmintrin.h>
+#else
+#define VIGOR_TEXTURE_BAKER_SSE2 0
+#endif
+
+namespace Vigor
+{
+	/*
+	* Offline texture bake, source image in, .vtex with its full mip chain out.
+	*
+	* Mips are filtered in linear light. Averaging sRGB encoded values directly darkens every level below the first,
+	*	which is what the runtime vkCmdBlitImage chain did. Alpha is already linear and is averaged as is.
+	*	Each level is then block compressed when the selected format is BCn, see TextureCompression.
+	*/
+	namespace TextureBaker
+	{
+		enum class TextureEncoding
+		{
+			Auto, // BC5 for normal maps, BC7 with alpha, BC1 without
+			RGBA8,
+			BC1,
+			BC3,
+			BC5,
+			BC7
+		};
+
+		/*
+		* What the texels mean decides the colour space of the format and how mips are filtered
+		*/
+		enum class TextureUsage
+		{
+			Color, // sRGB, filtered in linear light
+			Normal, // tangent space xy(z) in UNORM, renormalized per mip
+			Data // linear UNORM, e.g. masks and roughness
+		};
+
+		struct BakeOptions
+		{
+			TextureEncoding encoding = TextureEncoding::Auto;
+			TextureUsage usage = TextureUsage::Color;
+		};
+
+		static VkFormat SelectFormat(const BakeOptions& options, bool bHasAlpha)
+		{
+			bool bSrgb = options.usage == TextureUsage::Color;
+
+			TextureEncoding encoding = options.encoding;
+			if (encoding == TextureEncoding::Auto)
+			{
+				if (options.usage == TextureUsage::Normal)
+				{
+					encoding = TextureEncoding::BC5;
+				}
+				else
+				{
+					encoding = bHasAlpha ? TextureEncoding::BC7 : TextureEncoding::BC1;
+				}
+			}
+
+			switch (encoding)
+			{
+			case TextureEncoding::BC1:
+				return bSrgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+			case TextureEncoding::BC3:
+				return bSrgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+			case TextureEncoding::BC5:
+				return VK_FORMAT_BC5_UNORM_BLOCK; // two channels, no sRGB variant
+			case TextureEncoding::BC7:
+				return bSrgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+			default:
+				return bSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+			}
+		}
+
+		static const std::array<float, 256>& SrgbToLinearTable()
+		{
+			static const std::array<float, 256> table = []()
+			{
+				std::array<float, 256> values{};
+				for (size_t i = 0; i < values.size(); i++)
+				{
+					float srgb = static_cast<float>(i) / 255.0f;
+					values[i] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+				}
+				return values;
+			}();
+
+			return table;
+		}
+
+		static uint8_t LinearToSrgb(float linear)
+		{
+			linear = std::clamp(linear, 0.0f, 1.0f);
+			float srgb = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+
+			return static_cast<uint8_t>(srgb * 255.0f + 0.5f);
+		}
+
+		static uint8_t UnitToByte(float value)
+		{
+			return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+		/*
+		* RGBA8 to RGBA32F, 4 floats per texel. Colour channels are linearized when bSrgb is set
+		*/
+		static void DecodeLevel(const uint8_t* pixels, uint32_t texelCount, bool bSrgb, std::vector<float>& outLinear)
+		{
+			const std::array<float, 256>& toLinear = SrgbToLinearTable();
+
+			outLinear.resize(static_cast<size_t>(texelCount) * 4);
+			for (size_t i = 0; i < static_cast<size_t>(texelCount) * 4; i += 4)
+			{
+				for (size_t c = 0; c < 3; c++)
+				{
+					outLinear[i + c] = bSrgb ? toLinear[pixels[i + c]] : static_cast<float>(pixels[i + c]) / 255.0f;
+				}
+				outLinear[i + 3] = static_cast<float>(pixels[i + 3]) / 255.0f;
+			}
+		}
+
+		static void EncodeLevel(const std::vector<float>& linear, bool bSrgb, uint8_t* outPixels)
+		{
+			for (size_t i = 0; i < linear.size(); i += 4)
+			{
+				for (size_t c = 0; c < 3; c++)
+				{
+					outPixels[i + c] = bSrgb ? LinearToSrgb(linear[i + c]) : UnitToByte(linear[i + c]);
+				}
+				outPixels[i + 3] = UnitToByte(linear[i + 3]);
+			}
+		}
+
+		/*
+		* Averaged normals shorten, push them back onto the unit sphere so lower mips do not light darker
+		*/
+		static void RenormalizeLevel(std::vector<float>& linear)
+		{
+			for (size_t i = 0; i < linear.size(); i += 4)
+			{
+				float x = linear[i + 0] * 2.0f - 1.0f;
+				float y = linear[i + 1] * 2.0f - 1.0f;
+				float z = linear[i + 2] * 2.0f - 1.0f;
+
+				float length = std::sqrt(x * x + y * y + z * z);
+				if (length > 1e-6f)
+				{
+					linear[i + 0] = (x / length) * 0.5f + 0.5f;
+					linear[i + 1] = (y / length) * 0.5f + 0.5f;
+					linear[i + 2] = (z / length) * 0.5f + 0.5f;
+				}
+			}
+		}
+
+		static bool HasAlpha(const uint8_t* pixels, uint32_t texelCount)
+		{
+			for (size_t i = 0; i < static_cast<size_t>(texelCount); i++)
+			{
+				if (pixels[i * 4 + 3] != 255)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/*
+		* Source texels and weights behind one destination texel along one axis
+		*/
+		struct AxisTaps
+		{
+			std::array<uint32_t, 3> index;
+			std::array<float, 3> weight;
+			uint32_t count;
+		};
+
+		/*
+		* Even axes average pairs. Odd axes use the 3 tap polyphase box, texel i covers source [2i, 2i + 2] with weights
+		*	(dstSize - i, dstSize, i + 1) / (2 * dstSize + 1), so every source texel contributes equally across the level
+		*	and the last row/column is weighted in rather than dropped
+		*/
+		static void ComputeAxisTaps(uint32_t srcSize, uint32_t dstSize, std::vector<AxisTaps>& taps)
+		{
+			taps.resize(dstSize);
+
+			for (uint32_t i = 0; i < dstSize; i++)
+			{
+				AxisTaps& tap = taps[i];
+				if (srcSize == 1)
+				{
+					tap = { { 0, 0, 0 }, { 1.0f, 0.0f, 0.0f }, 1 };
+				}
+				else if (srcSize % 2 == 0)
+				{
+					tap = { { i * 2, i * 2 + 1, 0 }, { 0.5f, 0.5f, 0.0f }, 2 };
+				}
+				else
+				{
+					float span = static_cast<float>(dstSize * 2 + 1);
+					tap = { { i * 2, i * 2 + 1, i * 2 + 2 }, { (dstSize - i) / span, dstSize / span, (i + 1) / span }, 3 };
+				}
+			}
+		}
+
+		/*
+		* Box filter of one linear level into the next, dstWidth/dstHeight are half the source rounded down (at least 1).
+		*	A texel is 4 floats, exactly one SSE register, so each tap is a multiply and an add
+		*/
+		static void Downsample(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, std::vector<float>& dst, uint32_t dstWidth, uint32_t dstHeight)
+		{
+			dst.resize(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+			std::vector<AxisTaps> tapsX, tapsY;
+			ComputeAxisTaps(srcWidth, dstWidth, tapsX);
+			ComputeAxisTaps(srcHeight, dstHeight, tapsY);
+
+			for (uint32_t y = 0; y < dstHeight; y++)
+			{
+				const AxisTaps& tapY = tapsY[y];
+				float* dstRow = dst.data() + static_cast<size_t>(y) * dstWidth * 4;
+
+				for (uint32_t x = 0; x < dstWidth; x++)
+				{
+					const AxisTaps& tapX = tapsX[x];
+
+#if VIGOR_TEXTURE_BAKER_SSE2
+					__m128 sum = _mm_setzero_ps();
+					for (uint32_t ty = 0; ty < tapY.count; ty++)
+					{
+						const float* row = src.data() + static_cast<size_t>(tapY.index[ty]) * srcWidth * 4;
+
+						__m128 rowSum = _mm_setzero_ps();
+						for (uint32_t tx = 0; tx < tapX.count; tx++)
+						{
+							rowSum = _mm_add_ps(rowSum, _mm_mul_ps(_mm_loadu_ps(row + static_cast<size_t>(tapX.index[tx]) * 4), _mm_set1_ps(tapX.weight[tx])));
+						}
+						sum = _mm_add_ps(sum, _mm_mul_ps(rowSum, _mm_set1_ps(tapY.weight[ty])));
+					}
+					_mm_storeu_ps(dstRow + x * 4, sum);
+#else
+					for (size_t c = 0; c < 4; c++)
+					{
+						float sum = 0.0f;
+						for (uint32_t ty = 0; ty < tapY.count; ty++)
+						{
+							const float* row = src.data() + static_cast<size_t>(tapY.index[ty]) * srcWidth * 4;
+
+							float rowSum = 0.0f;
+							for (uint32_t tx = 0; tx < tapX.count; tx++)
+							{
+								rowSum += row[static_cast<size_t>(tapX.index[tx]) * 4 + c] * tapX.weight[tx];
+							}
+							sum += rowSum * tapY.weight[ty];
+						}
+						dstRow[x * 4 + c] = sum;
+					}
+#endif // VIGOR_TEXTURE_BAKER_SSE2
+				}
+			}
+		}
+
+		/*
+		* Bake sourcePath into bakedPath (defaults to TextureContainer::BakedPathFor), returns false with a log on failure
+		*/
+		static bool Bake(const std::string& sourcePath, std::string bakedPath = "", const BakeOptions& options = {})
+		{
+			if (bakedPath.empty())
+			{
+				bakedPath = TextureContainer::BakedPathFor(sourcePath);
+			}
+
+			int texWidth, texHeight, texChannels;
+			stbi_uc* pixels = stbi_load(sourcePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+			if (!pixels)
+			{
+				SDL_Log("Failed to bake %s: %s", sourcePath.c_str(), stbi_failure_reason());
+				return false;
+			}
+
+			uint32_t width = static_cast<uint32_t>(texWidth);
+			uint32_t height = static_cast<uint32_t>(texHeight);
+			uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+			if (mipLevels > TextureContainer::MaxMipLevels)
+			{
+				SDL_Log("Failed to bake %s: %ux%u is too large", sourcePath.c_str(), width, height);
+				stbi_image_free(pixels);
+				return false;
+			}
+
+			bool bSrgb = options.usage == TextureUsage::Color;
+			VkFormat format = SelectFormat(options, (texChannels == 2 || texChannels == 4) && HasAlpha(pixels, width * height));
+
+			TextureContainer::TextureData texture{};
+			texture.header.magic = TextureContainer::Magic;
+			texture.header.version = TextureContainer::Version;
+			texture.header.format = format;
+			texture.header.width = width;
+			texture.header.height = height;
+			texture.header.mipLevels = mipLevels;
+
+			// level 0 is stored from the source texels, the filter only ever reads the linear copy
+			std::vector<float> linearLevel;
+			DecodeLevel(pixels, width * height, bSrgb, linearLevel);
+
+			std::vector<float> nextLinearLevel;
+			std::vector<uint8_t> levelTexels;
+			uint32_t levelWidth = width;
+			uint32_t levelHeight = height;
+			for (uint32_t i = 0; i < mipLevels; i++)
+			{
+				TextureContainer::MipLevel& level = texture.header.levels[i];
+				level.offset = TextureContainer::AlignLevelOffset(texture.payload.size());
+				level.size = TextureCompression::LevelSize(format, levelWidth, levelHeight);
+				level.width = levelWidth;
+				level.height = levelHeight;
+
+				const uint8_t* texels = pixels;
+				if (i > 0)
+				{
+					levelTexels.resize(static_cast<size_t>(levelWidth) * levelHeight * 4);
+					EncodeLevel(linearLevel, bSrgb, levelTexels.data());
+					texels = levelTexels.data();
+				}
+
+				texture.payload.resize(level.offset + level.size);
+				uint8_t* levelBytes = reinterpret_cast<uint8_t*>(texture.payload.data() + level.offset);
+
+				if (TextureCompression::IsBlockCompressed(format))
+				{
+					TextureCompression::CompressLevel(texels, levelWidth, levelHeight, format, levelBytes);
+				}
+				else
+				{
+					memcpy(levelBytes, texels, level.size);
+				}
+
+				if (i + 1 < mipLevels)
+				{
+					uint32_t nextWidth = std::max(levelWidth / 2, 1u);
+					uint32_t nextHeight = std::max(levelHeight / 2, 1u);
+
+					Downsample(linearLevel, levelWidth, levelHeight, nextLinearLevel, nextWidth, nextHeight);
+					linearLevel.swap(nextLinearLevel);
+
+					if (options.usage == TextureUsage::Normal)
+					{
+						RenormalizeLevel(linearLevel);
+					}
+
+					levelWidth = nextWidth;
+					levelHeight = nextHeight;
+				}
+			}
+
+			stbi_image_free(pixels);
+
+			if (!TextureContainer::Write(bakedPath, texture))
+			{
+				SDL_Log("Failed to write baked texture to %s", bakedPath.c_str());
+				return false;
+			}
+
+			SDL_Log("Baked %s -> %s (%ux%u, %u mips, format %d, %zu bytes)", sourcePath.c_str(), bakedPath.c_str(), width, height, mipLevels, (int)format, texture.payload.size());
+			return true;
+		}
+	}
+}
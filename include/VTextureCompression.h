@@ -0,0 +1,461 @@
+#pragma once
+
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+namespace Vigor
+{
+	/*
+	* CPU block compression for the texture bake, 4x4 RGBA8 texels in, BCn blocks out.
+	*
+	* Endpoints come from the block's principal axis rather than its bounding box, which keeps diagonal gradients
+	*	intact. Indices are then chosen by testing every palette entry. BC7 only uses mode 6 (one subset, RGBA,
+	*	4 bit indices), not the best BC7 can do but already well ahead of BC1/BC3 on smooth colour and alpha.
+	*/
+	namespace TextureCompression
+	{
+		struct Block
+		{
+			uint8_t texels[16][4];
+		};
+
+		static bool IsBlockCompressed(VkFormat format)
+		{
+			switch (format)
+			{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		static uint32_t BlockBytes(VkFormat format)
+		{
+			return (format == VK_FORMAT_BC1_RGB_UNORM_BLOCK || format == VK_FORMAT_BC1_RGB_SRGB_BLOCK) ? 8 : 16;
+		}
+
+		/*
+		* Bytes for one width x height level, uncompressed formats are assumed to be 4 bytes per texel
+		*/
+		static uint64_t LevelSize(VkFormat format, uint32_t width, uint32_t height)
+		{
+			if (!IsBlockCompressed(format))
+			{
+				return static_cast<uint64_t>(width) * height * 4;
+			}
+
+			return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+		}
+
+		/*
+		* Blocks hanging off the right/bottom edge repeat the last row/column
+		*/
+		static void ExtractBlock(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block& outBlock)
+		{
+			for (uint32_t y = 0; y < 4; y++)
+			{
+				uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+				for (uint32_t x = 0; x < 4; x++)
+				{
+					uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+					memcpy(outBlock.texels[y * 4 + x], rgbaPixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+				}
+			}
+		}
+
+		/*
+		* Ends of the block's principal axis over the first channelCount channels, found by power iteration on the covariance
+		*/
+		static void FindEndpoints(const Block& block, uint32_t channelCount, float outLow[4], float outHigh[4])
+		{
+			float mean[4] = {};
+			float low[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+			float high[4] = {};
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					float value = block.texels[i][c];
+					mean[c] += value / 16.0f;
+					low[c] = std::min(low[c], value);
+					high[c] = std::max(high[c], value);
+				}
+			}
+
+			float covariance[4][4] = {};
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				for (uint32_t a = 0; a < channelCount; a++)
+				{
+					for (uint32_t b = 0; b < channelCount; b++)
+					{
+						covariance[a][b] += (block.texels[i][a] - mean[a]) * (block.texels[i][b] - mean[b]);
+					}
+				}
+			}
+
+			// the bounding box diagonal is a good first guess and avoids a zero start vector
+			float axis[4] = {};
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				axis[c] = high[c] - low[c];
+			}
+
+			for (uint32_t iteration = 0; iteration < 8; iteration++)
+			{
+				float next[4] = {};
+				float length = 0.0f;
+				for (uint32_t a = 0; a < channelCount; a++)
+				{
+					for (uint32_t b = 0; b < channelCount; b++)
+					{
+						next[a] += covariance[a][b] * axis[b];
+					}
+					length = std::max(length, std::abs(next[a]));
+				}
+
+				if (length < 1e-6f)
+				{
+					break; // flat block, keep the previous axis
+				}
+
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					axis[c] = next[c] / length;
+				}
+			}
+
+			float axisLengthSq = 0.0f;
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				axisLengthSq += axis[c] * axis[c];
+			}
+
+			float minProjection = 0.0f;
+			float maxProjection = 0.0f;
+			if (axisLengthSq > 1e-6f)
+			{
+				minProjection = FLT_MAX;
+				maxProjection = -FLT_MAX;
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					float projection = 0.0f;
+					for (uint32_t c = 0; c < channelCount; c++)
+					{
+						projection += (block.texels[i][c] - mean[c]) * axis[c];
+					}
+					minProjection = std::min(minProjection, projection / axisLengthSq);
+					maxProjection = std::max(maxProjection, projection / axisLengthSq);
+				}
+			}
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				outLow[c] = c < channelCount ? std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f) : 255.0f;
+				outHigh[c] = c < channelCount ? std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f) : 255.0f;
+			}
+		}
+
+		static uint32_t ColorDistanceSq(const int* a, const uint8_t* b, uint32_t channelCount)
+		{
+			uint32_t distance = 0;
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				int delta = a[c] - b[c];
+				distance += static_cast<uint32_t>(delta * delta);
+			}
+			return distance;
+		}
+
+		static uint16_t PackRGB565(const float color[3])
+		{
+			uint16_t r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+			uint16_t g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+			uint16_t b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		static void UnpackRGB565(uint16_t packed, int outColor[3])
+		{
+			int r = (packed >> 11) & 31;
+			int g = (packed >> 5) & 63;
+			int b = packed & 31;
+			outColor[0] = (r << 3) | (r >> 2);
+			outColor[1] = (g << 2) | (g >> 4);
+			outColor[2] = (b << 3) | (b >> 2);
+		}
+
+		/*
+		* 8 byte BC1 colour block, always in 4 colour mode (color0 > color1) so there is no punch-through black
+		*/
+		static void EncodeColorBlock(const Block& block, uint8_t* outBytes)
+		{
+			float low[4], high[4];
+			FindEndpoints(block, 3, low, high);
+
+			uint16_t color0 = PackRGB565(high);
+			uint16_t color1 = PackRGB565(low);
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+
+			uint32_t indices = 0;
+			if (color0 != color1) // equal endpoints would flip the block into 3 colour mode, index 0 alone is exact then
+			{
+				int palette[4][3];
+				UnpackRGB565(color0, palette[0]);
+				UnpackRGB565(color1, palette[1]);
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					uint32_t bestIndex = 0;
+					uint32_t bestDistance = UINT32_MAX;
+					for (uint32_t p = 0; p < 4; p++)
+					{
+						uint32_t distance = ColorDistanceSq(palette[p], block.texels[i], 3);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestIndex = p;
+						}
+					}
+					indices |= bestIndex << (i * 2);
+				}
+			}
+
+			outBytes[0] = static_cast<uint8_t>(color0 & 0xFF);
+			outBytes[1] = static_cast<uint8_t>(color0 >> 8);
+			outBytes[2] = static_cast<uint8_t>(color1 & 0xFF);
+			outBytes[3] = static_cast<uint8_t>(color1 >> 8);
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				outBytes[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+			}
+		}
+
+		/*
+		* 8 byte BC4 block of a single channel, also the alpha half of BC3 and each half of BC5
+		*/
+		static void EncodeChannelBlock(const Block& block, uint32_t channel, uint8_t* outBytes)
+		{
+			int low = 255;
+			int high = 0;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				low = std::min(low, static_cast<int>(block.texels[i][channel]));
+				high = std::max(high, static_cast<int>(block.texels[i][channel]));
+			}
+
+			outBytes[0] = static_cast<uint8_t>(high);
+			outBytes[1] = static_cast<uint8_t>(low);
+
+			uint64_t indices = 0;
+			if (high != low)
+			{
+				// 8 value mode: both endpoints then 6 evenly spaced steps from high towards low
+				int palette[8] = { high, low };
+				for (int p = 2; p < 8; p++)
+				{
+					palette[p] = ((8 - p) * high + (p - 1) * low) / 7;
+				}
+
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					uint64_t bestIndex = 0;
+					int bestDistance = INT32_MAX;
+					for (uint32_t p = 0; p < 8; p++)
+					{
+						int distance = std::abs(palette[p] - block.texels[i][channel]);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestIndex = p;
+						}
+					}
+					indices |= bestIndex << (i * 3);
+				}
+			}
+
+			for (uint32_t i = 0; i < 6; i++)
+			{
+				outBytes[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+			}
+		}
+
+		/*
+		* Packs fields least significant bit first, the order BC7 is specified in
+		*/
+		struct BitWriter
+		{
+			uint8_t* bytes;
+			uint32_t position = 0;
+
+			void Write(uint32_t value, uint32_t bitCount)
+			{
+				for (uint32_t bit = 0; bit < bitCount; bit++, position++)
+				{
+					if ((value >> bit) & 1)
+					{
+						bytes[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+					}
+				}
+			}
+		};
+
+		/*
+		* Mode 6 endpoints are 7 bits per channel plus one p-bit shared by the endpoint's channels, try both p-bits
+		*/
+		static void QuantizeBC7Endpoint(const float color[4], int outQuantized[4], int& outPBit)
+		{
+			float bestError = FLT_MAX;
+			for (int pBit = 0; pBit < 2; pBit++)
+			{
+				int quantized[4];
+				float error = 0.0f;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					quantized[c] = std::clamp(static_cast<int>(std::lround((color[c] - pBit) / 2.0f)), 0, 127);
+					float delta = static_cast<float>((quantized[c] << 1) | pBit) - color[c];
+					error += delta * delta;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					outPBit = pBit;
+					memcpy(outQuantized, quantized, sizeof(quantized));
+				}
+			}
+		}
+
+		static void EncodeBC7Block(const Block& block, uint8_t* outBytes)
+		{
+			static constexpr int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+			float low[4], high[4];
+			FindEndpoints(block, 4, low, high);
+
+			int endpoints[2][4];
+			int pBits[2];
+			QuantizeBC7Endpoint(low, endpoints[0], pBits[0]);
+			QuantizeBC7Endpoint(high, endpoints[1], pBits[1]);
+
+			int palette[16][4];
+			for (uint32_t p = 0; p < 16; p++)
+			{
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					int endpoint0 = (endpoints[0][c] << 1) | pBits[0];
+					int endpoint1 = (endpoints[1][c] << 1) | pBits[1];
+					palette[p][c] = ((64 - weights[p]) * endpoint0 + weights[p] * endpoint1 + 32) >> 6;
+				}
+			}
+
+			uint32_t indices[16];
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint32_t bestDistance = UINT32_MAX;
+				for (uint32_t p = 0; p < 16; p++)
+				{
+					uint32_t distance = ColorDistanceSq(palette[p], block.texels[i], 4);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						indices[i] = p;
+					}
+				}
+			}
+
+			// the first index is stored with its top bit implied zero, swap the endpoints if it is set
+			if (indices[0] & 8)
+			{
+				std::swap(endpoints[0], endpoints[1]);
+				std::swap(pBits[0], pBits[1]);
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					indices[i] = 15 - indices[i];
+				}
+			}
+
+			memset(outBytes, 0, 16);
+			BitWriter bitWriter{ outBytes };
+
+			bitWriter.Write(1 << 6, 7); // mode 6
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				bitWriter.Write(endpoints[0][c], 7);
+				bitWriter.Write(endpoints[1][c], 7);
+			}
+			bitWriter.Write(pBits[0], 1);
+			bitWriter.Write(pBits[1], 1);
+
+			bitWriter.Write(indices[0], 3);
+			for (uint32_t i = 1; i < 16; i++)
+			{
+				bitWriter.Write(indices[i], 4);
+			}
+		}
+
+		/*
+		* Compress a whole RGBA8 level into format, outBytes must hold LevelSize(format, width, height)
+		*/
+		static void CompressLevel(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, VkFormat format, uint8_t* outBytes)
+		{
+			uint32_t blockBytes = BlockBytes(format);
+			uint32_t blocksWide = (width + 3) / 4;
+			uint32_t blocksHigh = (height + 3) / 4;
+
+			Block block;
+			for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+			{
+				for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+				{
+					ExtractBlock(rgbaPixels, width, height, blockX, blockY, block);
+
+					uint8_t* blockOut = outBytes + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockBytes;
+					switch (format)
+					{
+					case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+					case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+						EncodeColorBlock(block, blockOut);
+						break;
+					case VK_FORMAT_BC3_UNORM_BLOCK:
+					case VK_FORMAT_BC3_SRGB_BLOCK:
+						EncodeChannelBlock(block, 3, blockOut);
+						EncodeColorBlock(block, blockOut + 8);
+						break;
+					case VK_FORMAT_BC5_UNORM_BLOCK:
+						EncodeChannelBlock(block, 0, blockOut);
+						EncodeChannelBlock(block, 1, blockOut + 8);
+						break;
+					case VK_FORMAT_BC7_UNORM_BLOCK:
+					case VK_FORMAT_BC7_SRGB_BLOCK:
+						EncodeBC7Block(block, blockOut);
+						break;
+					default:
+						break;
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+
+#include <SDL.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_core.h>
+
+#include "VFilesystem.h"
+
+namespace Vigor
+{
+	/*
+	* .vtex, the engine's baked texture container.
+	*
+	* A fixed size header followed by every mip level already in the GPU format, largest first. Levels are laid out
+	*	exactly as the staging buffer wants them so the whole payload goes up in one copy, no decoding or filtering at load.
+	*/
+	namespace TextureContainer
+	{
+		constexpr uint32_t Magic = 0x58455456; // "VTEX"
+		constexpr uint32_t Version = 1;
+
+		constexpr uint32_t MaxMipLevels = 16; // 32768^2, well past any device's maxImageDimension2D
+		constexpr uint64_t LevelAlignment = 16; // satisfies bufferOffset alignment for every texel/block size we write
+
+		struct MipLevel
+		{
+			uint64_t offset; // from the start of the payload
+			uint64_t size;
+			uint32_t width;
+			uint32_t height;
+		};
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t format; // VkFormat
+			uint32_t width;
+			uint32_t height;
+			uint32_t mipLevels;
+			MipLevel levels[MaxMipLevels];
+		};
+
+		struct TextureData
+		{
+			Header header;
+			std::vector<char> payload;
+		};
+
+		/*
+		* Where the baked copy of a source texture lives, alongside it with the extension swapped
+		*/
+		static std::string BakedPathFor(const std::string& sourcePath)
+		{
+			std::filesystem::path bakedPath(sourcePath);
+			bakedPath.replace_extension(".vtex");
+
+			return bakedPath.generic_string();
+		}
+
+		/*
+		* True if the baked file exists and is at least as new as its source
+		*/
+		static bool IsBakeCurrent(const std::string& sourcePath, const std::string& bakedPath)
+		{
+			std::error_code errorCode;
+			auto bakedTime = std::filesystem::last_write_time(bakedPath, errorCode);
+			if (errorCode)
+			{
+				return false;
+			}
+
+			auto sourceTime = std::filesystem::last_write_time(sourcePath, errorCode);
+			if (errorCode)
+			{
+				return true; // shipped without its source
+			}
+
+			return bakedTime >= sourceTime;
+		}
+
+		static uint64_t AlignLevelOffset(uint64_t offset)
+		{
+			return (offset + LevelAlignment - 1) & ~(LevelAlignment - 1);
+		}
+
+		static bool IsHeaderValid(const Header& header, size_t payloadSize)
+		{
+			if (header.magic != Magic || header.version != Version)
+			{
+				return false;
+			}
+
+			if (header.mipLevels == 0 || header.mipLevels > MaxMipLevels || header.width == 0 || header.height == 0)
+			{
+				return false;
+			}
+
+			for (uint32_t i = 0; i < header.mipLevels; i++)
+			{
+				const MipLevel& level = header.levels[i];
+				if (level.offset % LevelAlignment != 0 || level.offset + level.size > payloadSize)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/*
+		* Validate a mapped .vtex, the level offsets handed back are rebased to the start of the file.
+		*	Non throwing, a malformed file just means the texture is loaded from its source instead
+		*/
+		static bool TryParse(const uint8_t* fileData, size_t fileSize, const std::string& bakedPath, Header& outHeader)
+		{
+			if (fileSize < sizeof(Header))
+			{
+				return false;
+			}
+
+			memcpy(&outHeader, fileData, sizeof(Header));
+
+			if (!IsHeaderValid(outHeader, fileSize - sizeof(Header)))
+			{
+				SDL_Log("Baked texture %s is corrupt or from another version, ignoring it", bakedPath.c_str());
+				return false;
+			}
+
+			for (uint32_t i = 0; i < outHeader.mipLevels; i++)
+			{
+				outHeader.levels[i].offset += sizeof(Header);
+			}
+
+			return true;
+		}
+
+		static bool Write(const std::string& bakedPath, const TextureData& texture)
+		{
+			std::vector<char> fileData(sizeof(Header) + texture.payload.size());
+			memcpy(fileData.data(), &texture.header, sizeof(Header));
+			memcpy(fileData.data() + sizeof(Header), texture.payload.data(), texture.payload.size());
+
+			return Filesystem::WriteAtomic(bakedPath, fileData.data(), fileData.size());
+		}
+	}
+}
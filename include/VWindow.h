@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <deque>
 #include <chrono>
+#include <memory>
+#include <utility>
 #include <algorithm>
 #include <stdexcept>
 #include <unordered_map>
@@ -15,19 +19,24 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
 #include "VShaders.h"
 #include "VFilesystem.h"
+#include "VMemory.h"
+#include "VImages.h"
+#include "VAttachmentPool.h"
+#include "VResources.h"
 #include "VEngineTypes.h"
+#include "VPipelines.h"
+#include "VDescriptors.h"
+#include "VBindlessTextures.h"
 
 namespace Vigor
 {
-	constexpr uint8_t MAX_FRAMES_IN_FLIGHT = 3;
+	constexpr uint8_t MAX_FRAMES_IN_FLIGHT = 3; // upper bound of every FrameProfile, the profile sets how many are used
+
+	// every window's color targets share one block, as do their depth targets, see AttachmentPool
+	constexpr uint32_t COLOR_ALIAS_GROUP = 1;
+	constexpr uint32_t DEPTH_ALIAS_GROUP = 2;
 
 	struct alignas(16) ModelViewProjectionBuffer
 	{
@@ -65,9 +74,9 @@ namespace Vigor
 			}
 		}
 
-		void InitCommandBuffers(VkDevice vkDevice)
+		void InitCommandBuffers(VkDevice vkDevice, uint32_t framesInFlight)
 		{
-			commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+			commandBuffers.resize(framesInFlight);
 
 			VkCommandBufferAllocateInfo allocInfoCommandBuffer{};
 			allocInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -96,11 +105,14 @@ namespace Vigor
 			}
 		}
 
-		void InitSyncObjects(VkDevice vkDevice)
+		/*
+		* Acquire semaphores and fences, one per frame in flight. Render finished semaphores follow the swapchain,
+		*	see InitRenderFinishedSemaphores
+		*/
+		void InitSyncObjects(VkDevice vkDevice, uint32_t framesInFlight)
 		{
-			imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-			renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-			inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+			imageAvailableSemaphores.resize(framesInFlight);
+			inFlightFences.resize(framesInFlight);
 
 			VkSemaphoreCreateInfo createInfoSemaphore{};
 			createInfoSemaphore.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -109,34 +121,67 @@ namespace Vigor
 			createInfoFence.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 			createInfoFence.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+			for (size_t i = 0; i < framesInFlight; i++)
 			{
 				if (vkCreateSemaphore(vkDevice, &createInfoSemaphore, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS)
 				{
 					throw std::runtime_error("Failed to create imageAvailableSemaphore!");
 				}
 
-				if (vkCreateSemaphore(vkDevice, &createInfoSemaphore, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS)
+				if (vkCreateFence(vkDevice, &createInfoFence, nullptr, &inFlightFences[i]) != VK_SUCCESS)
 				{
-					throw std::runtime_error("Failed to create renderFinishedSemaphore!");
+					throw std::runtime_error("Failed to create inFlightFence!");
 				}
+			}
+		}
 
-				if (vkCreateFence(vkDevice, &createInfoFence, nullptr, &inFlightFences[i]) != VK_SUCCESS)
+		/*
+		* One per swapchain image. The present of an image waits on its semaphore, and the image can only be acquired again
+		*	once that present is done with it, so a signal never lands on a semaphore a present still has to consume
+		*	(per frame semaphores would be re-signalled every frame with a single frame in flight)
+		*/
+		void InitRenderFinishedSemaphores(VkDevice vkDevice, uint32_t imageCount)
+		{
+			renderFinishedSemaphores.resize(imageCount);
+
+			VkSemaphoreCreateInfo createInfoSemaphore{};
+			createInfoSemaphore.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+			for (size_t i = 0; i < imageCount; i++)
+			{
+				if (vkCreateSemaphore(vkDevice, &createInfoSemaphore, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS)
 				{
-					throw std::runtime_error("Failed to create inFlightFence!");
+					throw std::runtime_error("Failed to create renderFinishedSemaphore!");
 				}
 			}
 		}
 
-		void Shutdown(VkDevice vkDevice)
+		/*
+		* Per frame command buffers and sync objects only, the pools stay for the next InitCommandBuffers.
+		*	!! NOTE !! the frames must have completed
+		*/
+		void ShutdownFrames(VkDevice vkDevice)
 		{
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+			for (size_t i = 0; i < inFlightFences.size(); i++)
 			{
 				vkDestroySemaphore(vkDevice, imageAvailableSemaphores[i], nullptr);
-				vkDestroySemaphore(vkDevice, renderFinishedSemaphores[i], nullptr);
 				vkDestroyFence(vkDevice, inFlightFences[i], nullptr);
 			}
 
+			imageAvailableSemaphores.clear();
+			inFlightFences.clear();
+
+			if (!commandBuffers.empty())
+			{
+				vkFreeCommandBuffers(vkDevice, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+				commandBuffers.clear();
+			}
+		}
+
+		void Shutdown(VkDevice vkDevice)
+		{
+			ShutdownFrames(vkDevice);
+
 			vkDestroyCommandPool(vkDevice, commandPool, nullptr);
 			vkDestroyCommandPool(vkDevice, commandPoolTransient, nullptr);
 		}
@@ -148,7 +193,7 @@ namespace Vigor
 		VkCommandPool commandPoolTransient; // allocation and memory management for command buffers
 
 		std::vector<VkSemaphore> imageAvailableSemaphores;
-		std::vector<VkSemaphore> renderFinishedSemaphores;
+		std::vector<VkSemaphore> renderFinishedSemaphores; // per swapchain image, retired with the swapchain
 		std::vector<VkFence> inFlightFences;
 
 		friend class VWindow;
@@ -172,13 +217,10 @@ namespace Vigor
 			, presentQueue()
 			, renderPass()
 			, graphicsPipeline()
+			, fallbackPipeline()
 			, frameData()
-			, descriptorPool()
-			, descriptorSetLayout()
-			, vkIndexBuffer()
-			, vkVertexBuffer()
-			, vkIndexBufferMemory()
-			, vkVertexBufferMemory()
+			, descriptorBackend()
+			, attachmentPool(nullptr)
 		{
 			window = SDL_CreateWindow("VigorCMD", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth, windowHeight, SDL_WINDOW_SHOWN | SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
 			if (window == nullptr)
@@ -235,298 +277,49 @@ namespace Vigor
 			return frameData;
 		}
 
-		// Utils
-		static uint32_t FindMemoryType(VkPhysicalDevice vkPhysicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags memoryPropertyFlags)
+		const FrameProfile& GetFrameProfile() const
 		{
-			/*
-			* The VkPhysicalDeviceMemoryProperties structure has two arrays memoryTypes and memoryHeaps.
-			* Memory heaps are distinct memory resources like dedicated VRAM and swap space in RAM for when
-			*		VRAM runs out
-			*/
-			VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
-			vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice, &physicalDeviceMemoryProperties);
-
-			for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; i++)
-			{
-				if (
-					(typeFilter & (1 << i)) && // check available memory type idx against filter
-					(physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & memoryPropertyFlags))
-				{
-					return i;
-				}
-			}
-
-			throw std::runtime_error("Failed to find suitable memory type!");
-		}
-
-		static void CreateBuffer(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memoryPropertyFlags, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
-		{
-			VkBufferCreateInfo createInfoBuffer{};
-			createInfoBuffer.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-			createInfoBuffer.size = size;
-			createInfoBuffer.usage = usage;
-			createInfoBuffer.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-			if (vkCreateBuffer(vkDevice, &createInfoBuffer, nullptr, &buffer) != VK_SUCCESS)
-			{
-				throw std::runtime_error("Failed to create vertex buffer!");
-			}
-
-			VkMemoryRequirements memoryRequirements;
-			vkGetBufferMemoryRequirements(vkDevice, buffer, &memoryRequirements);
-
-			VkMemoryAllocateInfo memoryAllocateInfo{};
-			memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			memoryAllocateInfo.allocationSize = memoryRequirements.size;
-			memoryAllocateInfo.memoryTypeIndex = FindMemoryType
-			(
-				vkPhysicalDevice,
-				memoryRequirements.memoryTypeBits,
-				memoryPropertyFlags
-			);
-
-			if (vkAllocateMemory(vkDevice, &memoryAllocateInfo, nullptr, &bufferMemory) != VK_SUCCESS)
-			{
-				throw std::runtime_error("Failed to allocate vertex buffer memory!");
-			}
-
-			vkBindBufferMemory(vkDevice, buffer, bufferMemory, 0); // bind allocated memory
+			return frameProfile;
 		}
 
-		static void CreateImage
-		(
-			VkDevice vkDevice,
-			VkPhysicalDevice vkPhysicalDevice,
-			uint32_t texWidth,
-			uint32_t texHeight,
-			uint32_t mipLevels,
-			VkSampleCountFlagBits numSamples,
-			VkFormat format,
-			VkImageTiling tiling,
-			VkImageUsageFlags usage,
-			VkMemoryPropertyFlags properties,
-			VkImage& image,
-			VkDeviceMemory& imageMemory
-		)
-		{
-			VkImageCreateInfo createInfoImage{};
-			createInfoImage.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-			createInfoImage.imageType = VK_IMAGE_TYPE_2D;
-			createInfoImage.extent.width = static_cast<uint32_t>(texWidth);
-			createInfoImage.extent.height = static_cast<uint32_t>(texHeight);
-			createInfoImage.extent.depth = 1;
-			createInfoImage.mipLevels = 1;
-			createInfoImage.arrayLayers = 1;
-			createInfoImage.format = format;
-			createInfoImage.tiling = tiling;
-			createInfoImage.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			createInfoImage.usage = usage;
-			createInfoImage.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-			createInfoImage.samples = numSamples;
-			createInfoImage.flags = 0; // Optional
-			createInfoImage.mipLevels = mipLevels;
-
-			if (vkCreateImage(vkDevice, &createInfoImage, nullptr, &image) != VK_SUCCESS)
-			{
-				throw std::runtime_error("failed to create image!");
-			}
-
-			VkMemoryRequirements memoryRequirements;
-			vkGetImageMemoryRequirements(vkDevice, image, &memoryRequirements);
-
-			VkMemoryAllocateInfo allocInfoMemory{};
-			allocInfoMemory.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			allocInfoMemory.allocationSize = memoryRequirements.size;
-			allocInfoMemory.memoryTypeIndex = FindMemoryType
-			(
-				vkPhysicalDevice,
-				memoryRequirements.memoryTypeBits,
-				properties
-			);
-
-			if (vkAllocateMemory(vkDevice, &allocInfoMemory, nullptr, &imageMemory))
-			{
-				throw std::runtime_error("Failed to alloc image memory!");
-			}
-
-			vkBindImageMemory(vkDevice, image, imageMemory, 0);
-		}
-
-		static VkImageView CreateImageView(VkDevice vkDevice, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
-		{
-			VkImageViewCreateInfo imageViewCreateInfo{};
-			imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-			imageViewCreateInfo.image = image;
-			imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-			imageViewCreateInfo.format = format;
-			imageViewCreateInfo.subresourceRange.aspectMask = aspectFlags;
-			imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-			imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
-			imageViewCreateInfo.subresourceRange.layerCount = 1;
-			imageViewCreateInfo.subresourceRange.levelCount = mipLevels;
-
-			VkImageView imageView;
-			if (vkCreateImageView(vkDevice, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
-			{
-				throw std::runtime_error("Failed to create texture image view!");
-			}
-
-			return imageView;
-		}
-
-		static VkCommandBuffer BeginOneTimeCommands(VkDevice vkDevice, FrameData& frameData)
+		/*
+		* Present mode to ask for, a live swapchain is recreated with it on the next frame
+		*/
+		void SetPresentPolicy(PresentPolicy _presentPolicy)
 		{
-			VkCommandBufferAllocateInfo allocInfoCommandBuffer{};
-			allocInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-			allocInfoCommandBuffer.commandPool = frameData.commandPoolTransient;
-			allocInfoCommandBuffer.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; // primary can be submitted but not called from other buffers, secondary cannot be submitted but can be called from others
-			allocInfoCommandBuffer.commandBufferCount = 1;
+			presentPolicy = _presentPolicy;
 
-			VkCommandBuffer commandBuffer;
-			if (vkAllocateCommandBuffers(vkDevice, &allocInfoCommandBuffer, &commandBuffer) != VK_SUCCESS)
+			if (swapChain != VK_NULL_HANDLE)
 			{
-				throw std::runtime_error("Failed to allocate command buffers transient!");
+				bFrameBufferResized = true;
 			}
-
-			VkCommandBufferBeginInfo beginInfoCommandBuffer{};
-			beginInfoCommandBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-			beginInfoCommandBuffer.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-			vkBeginCommandBuffer(commandBuffer, &beginInfoCommandBuffer);
-
-			return commandBuffer;
 		}
 
-		static void EndOneTimeCommands(VkDevice vkDevice, VkQueue graphicsQueue, FrameData& frameData, VkCommandBuffer commandBuffer)
+		/*
+		* Tag presents with VK_KHR_present_id and pace FIFO modes on VK_KHR_present_wait when the device has them
+		*/
+		void InitPresentWait(VkDevice vkDevice, bool bPresentWait)
 		{
-			vkEndCommandBuffer(commandBuffer);
-
-			VkSubmitInfo submitInfo{};
-			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-			submitInfo.commandBufferCount = 1;
-			submitInfo.pCommandBuffers = &commandBuffer;
-
-			vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-			/*
-			* two possible ways to wait on this transfer to complete. We could use a fence and wait with vkWaitForFences,
-			*	or simply wait for the transfer queue to become idle with vkQueueWaitIdle. A fence would allow you to schedule
-			*	multiple transfers simultaneously and wait for all of them complete, instead of executing one at a time.
-			*	That may give the driver more opportunities to optimize.
-			*/
-			vkQueueWaitIdle(graphicsQueue);
-			vkFreeCommandBuffers(vkDevice, frameData.commandPoolTransient, 1, &commandBuffer);
+			vkWaitForPresentKHR = bPresentWait ? reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(vkDevice, "vkWaitForPresentKHR")) : nullptr;
 		}
 
-		static void TransitionImageLayout(VkDevice vkDevice, VkQueue graphicsQueue, FrameData& frameData, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
+		/*
+		* Frames in flight and swapchain depth, the per frame resources have to be (re)initialized after.
+		*	A live swapchain is recreated with the new image count on the next frame
+		*/
+		void SetFrameProfile(const FrameProfile& _frameProfile)
 		{
-			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, frameData);
-
-			VkImageMemoryBarrier imageMemoryBarrier{};
-			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			imageMemoryBarrier.oldLayout = oldLayout;
-			imageMemoryBarrier.newLayout = newLayout;
-			imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			imageMemoryBarrier.image = image;
-
-			imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-			imageMemoryBarrier.subresourceRange.levelCount = 1;
-			imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-			imageMemoryBarrier.subresourceRange.layerCount = mipLevels;
-
-			imageMemoryBarrier.srcAccessMask = 0; // TODO
-			imageMemoryBarrier.dstAccessMask = 0; // TODO
-
-			VkPipelineStageFlags srcStage;
-			VkPipelineStageFlags dstStage;
-
-			if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-			{
-				imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-
-				if (FormatHasStencilComponent(format))
-				{
-					imageMemoryBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
-				}
-			}
+			frameProfile = _frameProfile;
+			frameProfile.framesInFlight = std::clamp<uint32_t>(frameProfile.framesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
+			currentFrame = 0;
 
-			if(oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+			if (swapChain != VK_NULL_HANDLE)
 			{
-				imageMemoryBarrier.srcAccessMask = 0;
-				imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-				srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-				dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			}
-			else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-			{
-				imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-				imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-				srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-				dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+				bFrameBufferResized = true;
 			}
-			else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-			{
-				imageMemoryBarrier.srcAccessMask = 0;
-				imageMemoryBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-				srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-				dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-			}
-			else
-			{
-				throw std::invalid_argument("Unsupported layout transition!");
-			}
-
-			vkCmdPipelineBarrier
-			(
-				commandBuffer,
-				srcStage, dstStage,
-				0,
-				0, nullptr,
-				0, nullptr,
-				1, &imageMemoryBarrier
-			);
-
-			EndOneTimeCommands(vkDevice, graphicsQueue, frameData, commandBuffer);
-		}
-
-		static void CopyBufferToImage(VkDevice vkDevice, VkQueue graphicsQueue, FrameData& frameData, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
-		{
-			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, frameData);
-
-			VkBufferImageCopy bufferImageCopyRegion{};
-			bufferImageCopyRegion.bufferOffset = 0;
-			bufferImageCopyRegion.bufferRowLength = 0;
-			bufferImageCopyRegion.bufferImageHeight = 0;
-
-			bufferImageCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			bufferImageCopyRegion.imageSubresource.mipLevel = 0;
-			bufferImageCopyRegion.imageSubresource.baseArrayLayer = 0;
-			bufferImageCopyRegion.imageSubresource.layerCount = 1;
-
-			bufferImageCopyRegion.imageOffset = {0, 0, 0};
-			bufferImageCopyRegion.imageExtent = 
-			{
-				width,
-				height,
-				1
-			};
-
-			vkCmdCopyBufferToImage(
-				commandBuffer,
-				buffer,
-				image,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				1,
-				&bufferImageCopyRegion
-			);
-
-			EndOneTimeCommands(vkDevice, graphicsQueue, frameData, commandBuffer);
 		}
 
+		// Utils
 		static VkFormat GetSupportedFormat(VkPhysicalDevice vkPhysicalDevice, const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features)
 		{
 			for(VkFormat format : candidates)
@@ -561,124 +354,6 @@ namespace Vigor
 			);
 		}
 
-		static bool FormatHasStencilComponent(VkFormat format)
-		{
-			return format == VK_FORMAT_D32_SFLOAT_S8_UINT ||
-				format == VK_FORMAT_D24_UNORM_S8_UINT;
-		}
-
-		/*
-		* It is uncommon in practice to generate the mipmap levels at runtime.
-		* Usually they are pregenerated and stored in the texture file alongside the base level to improve 
-		*	loading speed. Implementing resizing in software and loading multiple levels from a file is TODO
-		*/
-		static void GenerateMipmaps
-		(
-			VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkQueue graphicsQueue, FrameData& frameData,
-			VkImage image, VkFormat imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels
-		)
-		{
-			// Check if image format supports linear blitting
-			VkFormatProperties formatProperties;
-			vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice, imageFormat, &formatProperties);
-
-			// image created with optimal tiling format, so we check against "optimalTilingFeatures"
-			if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
-			{
-				throw std::runtime_error("texture image format does not support linear blitting!");
-			}
-
-			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, frameData);
-
-			VkImageMemoryBarrier barrier{};
-			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			barrier.image = image;
-			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			barrier.subresourceRange.baseArrayLayer = 0;
-			barrier.subresourceRange.layerCount = 1;
-			barrier.subresourceRange.levelCount = 1;
-
-			int32_t mipWidth = texWidth;
-			int32_t mipHeight = texHeight;
-
-			for (uint32_t i = 1; i < mipLevels; i++)
-			{
-				barrier.subresourceRange.baseMipLevel = i - 1;
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-				vkCmdPipelineBarrier
-				(
-					commandBuffer,
-					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-					0, nullptr,
-					0, nullptr,
-					1, &barrier
-				);
-
-				VkImageBlit blit{};
-				blit.srcOffsets[0] = { 0, 0, 0 };
-				blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-				blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				blit.srcSubresource.mipLevel = i - 1;
-				blit.srcSubresource.baseArrayLayer = 0;
-				blit.srcSubresource.layerCount = 1;
-				blit.dstOffsets[0] = { 0, 0, 0 };
-				blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-				blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				blit.dstSubresource.mipLevel = i;
-				blit.dstSubresource.baseArrayLayer = 0;
-				blit.dstSubresource.layerCount = 1;
-
-				vkCmdBlitImage
-				(
-					commandBuffer,
-					image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-					image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-					1, &blit,
-					VK_FILTER_LINEAR
-				);
-
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-				vkCmdPipelineBarrier
-				(
-					commandBuffer,
-					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-					0, nullptr,
-					0, nullptr,
-					1, &barrier
-				);
-
-				if (mipWidth > 1) mipWidth /= 2;
-				if (mipHeight > 1) mipHeight /= 2;
-			}
-
-			barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-			vkCmdPipelineBarrier
-			(
-				commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier
-			);
-
-			EndOneTimeCommands(vkDevice, graphicsQueue, frameData, commandBuffer);
-		}
-
 		// Initializers
 		/*
 		* Init Window VK Surface
@@ -703,7 +378,7 @@ namespace Vigor
 		/*
 		* Initialize local swapcahin data
 		*/
-		void InitSwapChain(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, SwapChainSupportDetails swapChainSupportDetails, QueueFamilyIndicies queueFamilyIndicies)
+		void InitSwapChain(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, SwapChainSupportDetails swapChainSupportDetails, QueueFamilyIndicies queueFamilyIndicies, VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE)
 		{
 			// Choose Swap Chain Extent
 			{
@@ -745,12 +420,14 @@ namespace Vigor
 				swapChainSurfaceFormat = swapChainSupportDetails.formats[0];
 			}
 
-			// Choose Swap Present Mode
-			VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+			// Choose Swap Present Mode, FIFO is the only one every surface has to support
+			VkPresentModeKHR previousPresentMode = presentMode;
+			presentMode = VK_PRESENT_MODE_FIFO_KHR;
 			{
+				VkPresentModeKHR requestedPresentMode = GetPresentMode(presentPolicy);
 				for (const auto& availablePresentMode : swapChainSupportDetails.presentModes)
 				{
-					bool bIsPresentModeSupported = availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR;
+					bool bIsPresentModeSupported = availablePresentMode == requestedPresentMode;
 					if (!bIsPresentModeSupported)
 					{
 						continue;
@@ -758,9 +435,14 @@ namespace Vigor
 
 					presentMode = availablePresentMode;
 				}
+
+				if (presentMode != previousPresentMode || oldSwapChain == VK_NULL_HANDLE)
+				{
+					SDL_Log("Present mode: %s%s", GetPresentModeName(presentMode), presentMode != requestedPresentMode ? " (requested mode unavailable)" : "");
+				}
 			}
 
-			uint32_t imageCount = swapChainSupportDetails.capabilities.minImageCount + 1; // sticking to this minimum means that we may sometimes have to wait on the driver to complete internal operations before we can acquire another image to render to. Therefore it is recommended to request at least one more image than the minimum.
+			uint32_t imageCount = swapChainSupportDetails.capabilities.minImageCount + frameProfile.extraSwapchainImages; // sticking to this minimum means that we may sometimes have to wait on the driver to complete internal operations before we can acquire another image to render to, the low latency profile accepts that for a shorter queue.
 			if (swapChainSupportDetails.capabilities.maxImageCount > 0 && imageCount > swapChainSupportDetails.capabilities.maxImageCount)
 			{
 				imageCount = swapChainSupportDetails.capabilities.maxImageCount;
@@ -794,20 +476,22 @@ namespace Vigor
 			createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 			createInfo.presentMode = presentMode;
 			createInfo.clipped = VK_TRUE;
-			createInfo.oldSwapchain = VK_NULL_HANDLE;
+			createInfo.oldSwapchain = oldSwapChain; // lets the presentation engine hand its images over instead of starting cold
 
 			if (vkCreateSwapchainKHR(vkDevice, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
 			{
 				throw std::runtime_error("failed to create swap chain!");
 			}
 
+			swapChainFirstPresentId = presentId + 1; // ids are per swapchain, never wait on one given to the old swapchain
+
 			vkGetSwapchainImagesKHR(vkDevice, swapChain, &imageCount, nullptr);
 			swapChainImages.resize(imageCount);
 			vkGetSwapchainImagesKHR(vkDevice, swapChain, &imageCount, swapChainImages.data());
 		}
 
 		/*
-		* Initialize local swapcahin image views
+		* Initialize local swapcahin image views and the render finished semaphore presenting each image waits on
 		*/
 		void InitImageViews(VkDevice vkDevice)
 		{
@@ -815,374 +499,68 @@ namespace Vigor
 
 			for (size_t i = 0; i < swapChainImages.size(); i++)
 			{
-				swapChainImageViews[i] = CreateImageView(vkDevice, swapChainImages[i], swapChainSurfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+				swapChainImageViews[i] = Images::CreateImageView(vkDevice, swapChainImages[i], swapChainSurfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
 			}
+
+			frameData.InitRenderFinishedSemaphores(vkDevice, static_cast<uint32_t>(swapChainImages.size()));
 		}
 
 		/*
-		* Initialize render pass // TODO[CC] Handle Multiple
+		* Initialize render pass, shared with every other window whose swapchain uses the same formats.
+		*	Left null with dynamic rendering, DrawFrame then begins rendering straight on the attachment views
 		*/
-		void InitRenderPass(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples)
+		void InitRenderPass(VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples, PipelineRegistry& pipelineRegistry)
 		{
-			// COLOR
-			VkAttachmentDescription colorAttachment{};
-			colorAttachment.format = swapChainSurfaceFormat.format;
-			colorAttachment.samples = numSamples;
-			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // not doing anything with stencil yet so dont care
-			colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // not doing anything with stencil yet so dont care
-			colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-			// Sub-passes and attachment refs
-			VkAttachmentReference colorAttachmentRef{};
-			colorAttachmentRef.attachment = 0; // specifies which attachment to reference by its index
-			colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-			// this exists as we cannot present multisampled images so we must "resolve" the image first
-			VkAttachmentDescription colorAttachmentResolve{};
-			colorAttachmentResolve.format = swapChainSurfaceFormat.format;
-			colorAttachmentResolve.samples = VK_SAMPLE_COUNT_1_BIT;
-			colorAttachmentResolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-			colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-			colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-			colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-			VkAttachmentReference colorAttachmentResolveRef{};
-			colorAttachmentResolveRef.attachment = 2;
-			colorAttachmentResolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-			// DEPTH
-			VkAttachmentDescription depthAttachment{};
-			depthAttachment.format = GetDepthFormat(vkPhysicalDevice);
-			depthAttachment.samples = numSamples;
-			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-			depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-			depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-			depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-			VkAttachmentReference depthAttachmentRef{};
-			depthAttachmentRef.attachment = 1;
-			depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-			VkSubpassDescription subpass{};
-			subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // supports compute subpasses so need to be explicit
-			subpass.colorAttachmentCount = 1;
-			subpass.pColorAttachments = &colorAttachmentRef;
-			subpass.pDepthStencilAttachment = &depthAttachmentRef;
-			subpass.pResolveAttachments = &colorAttachmentResolveRef;
-
-			/* -- NOTE --
-			* The index of the attachment in this array is directly referenced from the fragment shader with "layout(location = 0) out vec4 outColor" in OpenGL
-			*
-			* The following other types of attachments can be referenced by a subpass:
-			*   - pInputAttachments: Attachments that are read from a shader
-			*   - pResolveAttachments: Attachments used for multisampling color attachments
-			*   - pDepthStencilAttachment: Attachment for depth and stencil data
-			*   - pPreserveAttachments: Attachments that are not used by this subpass, but for which the data must be preserved
-			*/
-
-			VkSubpassDependency subpassDependency{};
-			// dependant subpass and dependency
-			subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-			subpassDependency.dstSubpass = 0;
-			// what do we wait on
-			subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-			subpassDependency.srcAccessMask = 0;
-			// wait on color attachment stage and the writing of this, dont transition until allowed + necessary
-			subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-			subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-			std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
-			VkRenderPassCreateInfo createInfoRenderPass{};
-			createInfoRenderPass.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-			createInfoRenderPass.attachmentCount = static_cast<uint32_t>(attachments.size());
-			createInfoRenderPass.pAttachments = attachments.data();
-			createInfoRenderPass.subpassCount = 1;
-			createInfoRenderPass.pSubpasses = &subpass;
-			// use subpass depenency
-			createInfoRenderPass.dependencyCount = 1;
-			createInfoRenderPass.pDependencies = &subpassDependency;
-
-			VkResult createRenderPassRes = vkCreateRenderPass(vkDevice, &createInfoRenderPass, nullptr, &renderPass);
-			if (createRenderPassRes != VK_SUCCESS)
+			if (pipelineRegistry.IsDynamicRendering())
 			{
-				std::string errorMsg = std::format("Failed to create render pass Error: {}\n\n", (int)createRenderPassRes);
-				throw std::runtime_error(errorMsg);
+				renderPass = VK_NULL_HANDLE;
+				return;
 			}
+
+			renderPass = pipelineRegistry.AcquireRenderPass(swapChainSurfaceFormat.format, GetDepthFormat(vkPhysicalDevice), numSamples);
 		}
 
 		/*
 		* Initialize Descriptor Set And Layout
 		*/
-		void InitDescriptorSetLayout(VkDevice vkDevice)
+		void InitDescriptorSetLayout(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, DescriptorBackendType descriptorBackendType, VkDescriptorSetLayout sharedSetLayout)
 		{
-			VkDescriptorSetLayoutBinding mvpBufferLayoutBinding{};
-			mvpBufferLayoutBinding.binding = 0;
-			mvpBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			mvpBufferLayoutBinding.descriptorCount = 1;
-			mvpBufferLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-			mvpBufferLayoutBinding.pImmutableSamplers = nullptr;
-
-			VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-			samplerLayoutBinding.binding = 1;
-			samplerLayoutBinding.descriptorCount = 1;
-			samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			samplerLayoutBinding.pImmutableSamplers = nullptr;
-			samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-			std::array<VkDescriptorSetLayoutBinding, 2> bindings = { mvpBufferLayoutBinding, samplerLayoutBinding };
-			VkDescriptorSetLayoutCreateInfo createInfoDescriptorSetLayout{};
-			createInfoDescriptorSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-			createInfoDescriptorSetLayout.bindingCount = static_cast<uint32_t>(bindings.size());
-			createInfoDescriptorSetLayout.pBindings = bindings.data();
-
-			if (vkCreateDescriptorSetLayout(vkDevice, &createInfoDescriptorSetLayout, nullptr, &descriptorSetLayout) != VK_SUCCESS)
-			{
-				throw std::runtime_error("failed to create descriptor set layout!");
-			}
+			// backend is resolved by the engine, it has to match how the texture table was created
+			descriptorBackend = Descriptors::CreateBackend(descriptorBackendType, vkPhysicalDevice);
+
+			// only the per window storage is ours, the layout is the engine's
+			descriptorBackend->ShareSetLayout(sharedSetLayout);
+			descriptorBackend->InitSetLayout(vkDevice, Descriptors::GetFrameSetBindings());
 		}
 
 		/*
 		* Initialize Graphics Pipeline And Layou And Shader Modules
 		*/
-		void InitGraphicsPipelineAndLayoutAndShaderModules(VkDevice vkDevice, VkSampleCountFlagBits numSamples) // TODO[CC] - split this up
+		void InitGraphicsPipelineAndLayoutAndShaderModules(VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples, PipelineRegistry& pipelineRegistry) // TODO[CC] - split this up
 		{
-			// Shader Module Setup
-			auto VertexShaderCode = Filesystem::Read("./shaders/glsl/vert.spv");
-			auto FragmentShaderCode = Filesystem::Read("./shaders/glsl/frag.spv");
-
-			VkShaderModule vertexShaderModule = Shaders::CreateShaderModule(VertexShaderCode, vkDevice);
-			VkShaderModule fragmentShaderModule = Shaders::CreateShaderModule(FragmentShaderCode, vkDevice);
-
-			VkPipelineShaderStageCreateInfo createInfoVertexShaderStage{};
-			createInfoVertexShaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-			createInfoVertexShaderStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
-			createInfoVertexShaderStage.module = vertexShaderModule;
-			createInfoVertexShaderStage.pName = "main";
-
-			VkPipelineShaderStageCreateInfo createInfoFragmentShaderStage{};
-			createInfoFragmentShaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-			createInfoFragmentShaderStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-			createInfoFragmentShaderStage.module = fragmentShaderModule;
-			createInfoFragmentShaderStage.pName = "main";
-
-			VkPipelineShaderStageCreateInfo shaderStages[] = { createInfoVertexShaderStage, createInfoFragmentShaderStage };
-
-			// Dynamic State Setup
-			VkPipelineDynamicStateCreateInfo createInfoDynamicState{};
-			createInfoDynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-			createInfoDynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()); // TODO - remove cast if possible
-			createInfoDynamicState.pDynamicStates = dynamicStates.data();
-
-			// Get Vertex structure values
-			auto bindingDescription = Vertex::GetBindingDescription();
-			auto attributeDescriptions = Vertex::GetAttributeDescriptions();
-
-			// Vertex Input
-			VkPipelineVertexInputStateCreateInfo createInfoVertexInput{};
-			createInfoVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-			createInfoVertexInput.vertexBindingDescriptionCount = 1;
-			createInfoVertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-			createInfoVertexInput.pVertexBindingDescriptions = &bindingDescription;
-			createInfoVertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-			// Input Assembly
-			VkPipelineInputAssemblyStateCreateInfo createInfoInputAssembly{};
-			createInfoInputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-			createInfoInputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-			createInfoInputAssembly.primitiveRestartEnable = VK_FALSE; // if VK_TRUE, then it's possible to break up lines and triangles in the _STRIP topology modes by using a special index of 0xFFFF or 0xFFFFFFFF.
-
-			// Viewport and Scissor
-			/* -- NOTE --
-			* Viewport defines the region that pixels transformed from an image to the framebuffer
-			* Scissor defines the region of pixels that are stored, anything outside this within the viewport are discarded by the rasterizer
-			*/
-
-			/* -- NOTE --
-			* These can be setup as static as part of pipeline state but are supported as dynamic
-			* This generally doesnt have a noticeable perf hit and is worthwhile as commonly needed
-			*/
-
-			// Viewport
-			VkViewport viewport{};
-			viewport.x = 0.0f;
-			viewport.y = 0.0f;
-			viewport.width = (float)swapChainExtent.width; // -- NOTE -- Swap chain width and height can differ from window height/width, but will be what we use as framebuffers
-			viewport.height = (float)swapChainExtent.height; // -- NOTE -- Swap chain width and height can differ from window height/width, but will be what we use as framebuffers
-			viewport.minDepth = 0.0f; // -- NOTE -- these values are normalised within 0 - 1
-			viewport.maxDepth = 1.0f; // -- NOTE -- these values are normalised within 0 - 1
-
-			// Scissor
-			VkRect2D scissor{};
-			scissor.offset = { 0,0 };
-			scissor.extent = swapChainExtent; // This scissor covers the entire range of the vieport so no pixels are discarded by the rstr
+			// Pipeline Layout - set 0 is per window uniforms, set 1 is the engine's bindless texture table
+			pipelineLayout = pipelineRegistry.GetPipelineLayout();
 
 			/* -- NOTE --
-			* With dynamic state it's even possible to specify different viewports and or scissor rectangles within a single command buffer.
-			*
-			* Without dynamic state, the viewport and scissor rectangle need to be set in the pipeline using the VkPipelineViewportStateCreateInfo struct.
-			* This makes the viewport and scissor rectangle for this pipeline immutable.
-			* Any changes required to these values would require a new pipeline to be created with the new values.
-			*
-			* Using multiple requires enabling a GPU feature (see logical device init).
-			*/
-
-			// Viewport Pipeline
-			VkPipelineViewportStateCreateInfo createInfoViewportState{};
-			createInfoViewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-			createInfoViewportState.viewportCount = 1;
-			createInfoViewportState.pViewports = &viewport;
-			createInfoViewportState.scissorCount = 1;
-			createInfoViewportState.pScissors = &scissor;
-
-			// Rasterizer
-			VkPipelineRasterizationStateCreateInfo createInfoRasterizerState{};
-			createInfoRasterizerState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-			/*
-			* if VK_TRUE, then fragments that are beyond the near and far planes are clamped to them as opposed to discarding them.
-			* This is useful in some special cases like shadow maps.
-			* Using this requires enabling a GPU feature.
+			* Pipelines, their layout and the render pass are owned by the engine's registry and shared between
+			*	windows with the same state, a window only creates what depends on its swapchain.
 			*/
-			createInfoRasterizerState.depthClampEnable = VK_FALSE;
-			createInfoRasterizerState.rasterizerDiscardEnable = VK_FALSE; // if VK_TRUE, then geometry never passes through the rasterizer stage. This disables any output to the framebuffer.
-			createInfoRasterizerState.polygonMode = VK_POLYGON_MODE_FILL; // Using any mode other than fill requires enabling a GPU feature.
-			createInfoRasterizerState.lineWidth = 1.0f; // describes the thickness of lines in number of fragments. The maximum line width depends on the hardware, any line thicker than 1.0f requires the "wideLines" GPU feature.
-			createInfoRasterizerState.cullMode = VK_CULL_MODE_BACK_BIT;
-			createInfoRasterizerState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-			/*
-			* The rasterizer can alter the depth values by adding a constant value or biasing them based on a fragment's slope.
-			* This is sometimes used for shadow mapping, but we won't be using it so depthBiasEnable is set to VK_FALSE
-			*/
-			createInfoRasterizerState.depthBiasEnable = VK_FALSE;
-			createInfoRasterizerState.depthBiasConstantFactor = 0.0f; // Optional
-			createInfoRasterizerState.depthBiasClamp = 0.0f; // Optional
-			createInfoRasterizerState.depthBiasSlopeFactor = 0.0f; // Optional
-
-			// MSAA (Multisampling) - Disabled with this config
-			VkPipelineMultisampleStateCreateInfo createInfoMultisampling{};
-			createInfoMultisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-			createInfoMultisampling.sampleShadingEnable = VK_FALSE;
-			createInfoMultisampling.rasterizationSamples = numSamples;
-			createInfoMultisampling.minSampleShading = 1.0f; // Optional
-			createInfoMultisampling.pSampleMask = nullptr; // Optional
-			createInfoMultisampling.alphaToCoverageEnable = VK_FALSE; // Optional
-			createInfoMultisampling.alphaToOneEnable = VK_FALSE; // Optional
-			createInfoMultisampling.sampleShadingEnable = VK_TRUE; // enable sample shading in the pipeline
-			createInfoMultisampling.minSampleShading = .2f; // min fraction for sample shading; closer to one is smoother
-
-			/* Depth and Stencil testing
-			* To configure this VkPipelineDepthStencilStateCreateInfo must be used but is ignored for now
-			*/
-
-			// Color Blending - (At the moment the following config doesnt perform any color blending with the chosen settings)
-			/* -- NOTE --
-			* There are two types of structs to configure color blending.
-			* The first struct, VkPipelineColorBlendAttachmentState contains the configuration per attached framebuffer.
-			* The second struct, VkPipelineColorBlendStateCreateInfo contains the global color blending settings.
-			*
-			* ATM we only have one framebuffer, so we do the following:
-			*/
-
-			// Per frame buffer
-			VkPipelineColorBlendAttachmentState createInfoColorBlendAttachment{};
-			createInfoColorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-
-			// Blending Disabled:
-			createInfoColorBlendAttachment.blendEnable = VK_FALSE; // the new color from the fragment shader is passed through unmodified, otherwise the resulting color is AND'd with the colorWriteMask to determine which channels are actually passed through
-			createInfoColorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-			createInfoColorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-			createInfoColorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD; // Optional
-			createInfoColorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-			createInfoColorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-			createInfoColorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD; // Optional
-
-			// Alpha blending:
-			//createInfoColorBlendAttachment.blendEnable = VK_TRUE;
-			//createInfoColorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-			//createInfoColorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-			//createInfoColorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-			//createInfoColorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-			//createInfoColorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-			//createInfoColorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-			// Global blend settings
-			VkPipelineColorBlendStateCreateInfo createInfoColorBlending{};
-			createInfoColorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-			createInfoColorBlending.logicOpEnable = VK_FALSE; // set to true to utilize bitwise blending, will act as if each attachment has blendEnable set to false
-			createInfoColorBlending.logicOp = VK_LOGIC_OP_COPY; // Optional
-			createInfoColorBlending.attachmentCount = 1;
-			createInfoColorBlending.pAttachments = &createInfoColorBlendAttachment;
-			createInfoColorBlending.blendConstants[0] = 0.0f; // Optional
-			createInfoColorBlending.blendConstants[1] = 0.0f; // Optional
-			createInfoColorBlending.blendConstants[2] = 0.0f; // Optional
-			createInfoColorBlending.blendConstants[3] = 0.0f; // Optional
-
-			// Pipeline Layout - empty for now, need to specificy uniforms here when used
-			VkPipelineLayoutCreateInfo createInfoPipelineLayout{};
-			createInfoPipelineLayout.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-			createInfoPipelineLayout.setLayoutCount = 1;
-			createInfoPipelineLayout.pSetLayouts = &descriptorSetLayout;
-			createInfoPipelineLayout.pushConstantRangeCount = 0; // Optional
-			createInfoPipelineLayout.pPushConstantRanges = nullptr; // Optional
-
-			if (vkCreatePipelineLayout(vkDevice, &createInfoPipelineLayout, nullptr, &pipelineLayout) != VK_SUCCESS)
-			{
-				throw std::runtime_error("Failed to create pipeline layout!");
-			}
-
-			VkPipelineDepthStencilStateCreateInfo depthStencil{};
-			depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-			depthStencil.depthTestEnable = VK_TRUE;
-			depthStencil.depthWriteEnable = VK_TRUE;
-			depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-			depthStencil.depthBoundsTestEnable = VK_FALSE;
-			depthStencil.minDepthBounds = 0.0f; // Optional
-			depthStencil.maxDepthBounds = 1.0f; // Optional
-			depthStencil.stencilTestEnable = VK_FALSE;
-			depthStencil.front = {}; // Optional
-			depthStencil.back = {}; // Optional
-
-			// Create the pipeline
-			VkGraphicsPipelineCreateInfo createInfoGraphicsPipeline{};
-			createInfoGraphicsPipeline.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-			createInfoGraphicsPipeline.stageCount = 2; // number of shader stages
-			createInfoGraphicsPipeline.pStages = shaderStages;
-			createInfoGraphicsPipeline.pVertexInputState = &createInfoVertexInput;
-			createInfoGraphicsPipeline.pInputAssemblyState = &createInfoInputAssembly;
-			createInfoGraphicsPipeline.pViewportState = &createInfoViewportState;
-			createInfoGraphicsPipeline.pRasterizationState = &createInfoRasterizerState;
-			createInfoGraphicsPipeline.pMultisampleState = &createInfoMultisampling;
-			createInfoGraphicsPipeline.pDepthStencilState = nullptr; // not used yet
-			createInfoGraphicsPipeline.pColorBlendState = &createInfoColorBlending;
-			createInfoGraphicsPipeline.pDynamicState = &createInfoDynamicState;
-			createInfoGraphicsPipeline.layout = pipelineLayout;
-
-			// https://registry.khronos.org/vulkan/specs/1.3-extensions/html/chap8.html#renderpass-compatibility
-			createInfoGraphicsPipeline.renderPass = renderPass;
-			createInfoGraphicsPipeline.subpass = 0; // idx
-
-			//Vulkan allows you to create a new graphics pipeline by deriving from an existing pipeline
-			createInfoGraphicsPipeline.basePipelineHandle = VK_NULL_HANDLE;
-			createInfoGraphicsPipeline.basePipelineIndex = -1;
-
-			// use depth stencil state for depth testing of fragment shaders for discard
-			createInfoGraphicsPipeline.pDepthStencilState = &depthStencil;
-
-			// pipeline cache and batch pipeline creation can also be configured
-			if (vkCreateGraphicsPipelines(vkDevice, VK_NULL_HANDLE, 1, &createInfoGraphicsPipeline, nullptr, &graphicsPipeline) != VK_SUCCESS)
-			{
-				throw std::runtime_error("Failed to create graphics pipeline!");
-			}
-
-			// Shader Module Cleanup
-			vkDestroyShaderModule(vkDevice, vertexShaderModule, nullptr);
-			vkDestroyShaderModule(vkDevice, fragmentShaderModule, nullptr);
+			PipelineStateKey pipelineStateKey{};
+			pipelineStateKey.vertexShaderPath = "shader.vert"; // embedded, no file I/O or working directory dependency
+			pipelineStateKey.fragmentShaderPath = "shader.frag";
+			pipelineStateKey.colorFormat = swapChainSurfaceFormat.format;
+			pipelineStateKey.depthFormat = GetDepthFormat(vkPhysicalDevice);
+			pipelineStateKey.rasterizationSamples = numSamples;
+
+			// LoadModel whites out vertex colors, so skip the multiply
+			pipelineStateKey.shaderFeatures = ShaderFeatures::Textured;
+
+			// Sample shading off is cheaper to build and to run, drawn with until the full quality variant is ready
+			pipelineStateKey.bSampleShading = false;
+			fallbackPipeline = pipelineRegistry.Acquire(pipelineStateKey, true);
+
+			pipelineStateKey.bSampleShading = true;
+			graphicsPipeline = pipelineRegistry.Acquire(pipelineStateKey);
 		}
 
 		/*
@@ -1190,11 +568,16 @@ namespace Vigor
 		*/
 		void InitFrameBuffers(VkDevice vkDevice)
 		{
+			if (renderPass == VK_NULL_HANDLE)
+			{
+				return; // dynamic rendering, nothing to rebuild on resize
+			}
+
 			swapChainFramebuffers.resize(swapChainImageViews.size());
 
 			for (size_t i = 0; i < swapChainImageViews.size(); i++)
 			{
-				std::array<VkImageView, 3> attachments = { colorImageView, depthImageView, swapChainImageViews[i] };
+				std::array<VkImageView, 3> attachments = { colorAttachment.imageView, depthAttachment.imageView, swapChainImageViews[i] };
 				VkFramebufferCreateInfo createInfoFrameBuffer{};
 				createInfoFrameBuffer.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 				createInfoFrameBuffer.renderPass = renderPass;
@@ -1216,374 +599,92 @@ namespace Vigor
 		/*
 		* Initialize Color Resources
 		*/
-		void InitColorResources(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples)
+		void InitColorResources(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples, AttachmentPool& _attachmentPool)
 		{
-			VkFormat colorFormat = swapChainSurfaceFormat.format;
+			attachmentPool = &_attachmentPool; // kept for swapchain recreation
 
-			CreateImage
+			colorAttachment = attachmentPool->Acquire
 			(
 				vkDevice,
 				vkPhysicalDevice,
 				swapChainExtent.width,
 				swapChainExtent.height,
-				1,
 				numSamples,
-				colorFormat,
-				VK_IMAGE_TILING_OPTIMAL,
+				swapChainSurfaceFormat.format,
 				VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				colorImage,
-				colorImageMemory
-			);
-
-			colorImageView = CreateImageView
-			(
-				vkDevice,
-				colorImage,
-				colorFormat,
 				VK_IMAGE_ASPECT_COLOR_BIT,
-				1
-			);
-		}
-
-		/*
-		* Initialize Depth Buffer Resources
-		*/
-		void InitDepthBufferResources(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples)
-		{
-			VkFormat depthFormat = GetDepthFormat(vkPhysicalDevice);
-			CreateImage
-			(
-				vkDevice,
-				vkPhysicalDevice,
-				swapChainExtent.width,
-				swapChainExtent.height,
-				1,
-				numSamples,
-				depthFormat,
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				depthImage,
-				depthImageMemory
-			);
-			depthImageView = CreateImageView(vkDevice, depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
-
-			TransitionImageLayout
-			(
-				vkDevice,
-				graphicsQueue,
-				frameData,
-				depthImage,
-				depthFormat,
-				VK_IMAGE_LAYOUT_UNDEFINED,
-				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-				1
+				COLOR_ALIAS_GROUP
 			);
 		}
 
 		/*
-		* Initialize Texture Image
+		* Size of the MSAA color and depth attachments against what is actually committed for them. Lazily allocated
+		*	memory is only backed where a tiler spills, elsewhere the attachments are fully resident
 		*/
-		void InitTextureImage(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, const std::string& texturePath)
+		void LogAttachmentMemory(VkDevice vkDevice) const
 		{
-			int texWidth, texHeight, texChannels;
-			stbi_uc* pixels = stbi_load(texturePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-			VkDeviceSize imageSize = texWidth * texHeight * 4;
+			VkDeviceSize attachmentBytes = 0;
+			VkDeviceSize committedBytes = 0;
+			bool bLazilyAllocated = false;
 
-			if (!pixels)
+			std::array<std::pair<VkImage, VkDeviceMemory>, 2> attachments = { std::make_pair(colorAttachment.image, colorAttachment.memory), std::make_pair(depthAttachment.image, depthAttachment.memory) };
+			for (const auto& [image, imageMemory] : attachments)
 			{
-				throw std::runtime_error("failed to load texture image!");
-			}
-
-			mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+				VkMemoryRequirements memoryRequirements;
+				vkGetImageMemoryRequirements(vkDevice, image, &memoryRequirements);
+				attachmentBytes += memoryRequirements.size;
 
-			VkBuffer stagingBuffer;
-			VkDeviceMemory stagingBufferMemory;
-			CreateBuffer
-			(
-				vkDevice,
-				vkPhysicalDevice,
-				imageSize,
-				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				stagingBuffer,
-				stagingBufferMemory
-			);
-
-			void* data;
-			vkMapMemory(vkDevice, stagingBufferMemory, 0, imageSize, 0, &data);
-			memcpy(data, pixels, static_cast<size_t>(imageSize));
-			vkUnmapMemory(vkDevice, stagingBufferMemory);
-
-			stbi_image_free(pixels);
-
-			CreateImage
-			(
-				vkDevice,
-				vkPhysicalDevice,
-				texWidth,
-				texHeight,
-				mipLevels,
-				VK_SAMPLE_COUNT_1_BIT,
-				VK_FORMAT_R8G8B8A8_SRGB,
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				textureImage,
-				textureImageMemory
-			);
-
-			TransitionImageLayout
-			(
-				vkDevice,
-				graphicsQueue,
-				frameData,
-				textureImage,
-				VK_FORMAT_R8G8B8A8_SRGB,
-				VK_IMAGE_LAYOUT_UNDEFINED,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				mipLevels
-			);
-
-			//transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-
-			CopyBufferToImage
-			(
-				vkDevice,
-				graphicsQueue,
-				frameData,
-				stagingBuffer,
-				textureImage,
-				static_cast<uint32_t>(texWidth),
-				static_cast<uint32_t>(texHeight)
-			);
-
-			// Cleanup
-			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
-			vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
-
-			GenerateMipmaps
-			(
-				vkDevice,
-				vkPhysicalDevice,
-				graphicsQueue,
-				frameData,
-				textureImage,
-				VK_FORMAT_R8G8B8A8_SRGB,
-				texWidth,
-				texHeight,
-				mipLevels
-			);
-		}
-
-		/*
-		* Initialize Texture Image View
-		*/
-		void InitTextureImageView(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
-		{
-			textureImageView = CreateImageView(vkDevice, textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
-		}
-
-		/*
-		* Initialize Texture Sampler
-		*/
-		void InitTextureSampler(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
-		{
-			VkSamplerCreateInfo createInfoSampler{};
-			createInfoSampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-			createInfoSampler.magFilter = VK_FILTER_LINEAR;
-			createInfoSampler.minFilter = VK_FILTER_LINEAR;
-			createInfoSampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-			createInfoSampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-			createInfoSampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-
-			// TODO[CC] - remove this and just collect during engine init and use dependancy injection to put query them here
-			VkPhysicalDeviceProperties physicalDeviceProperties{};
-			vkGetPhysicalDeviceProperties(vkPhysicalDevice, &physicalDeviceProperties);
-
-			createInfoSampler.anisotropyEnable = VK_TRUE;
-			createInfoSampler.maxAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
-
-			// Can choose to ignore filtering in the sampler
-			//createInfoSampler.anisotropyEnable = VK_FALSE;
-			//createInfoSampler.maxAnisotropy = 1.0f;
-
-			createInfoSampler.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-
-			// sample in the range of [0, 1)
-			createInfoSampler.unnormalizedCoordinates = VK_FALSE;
-
-			createInfoSampler.compareEnable = VK_FALSE; // mainly used for percentage-closer filtering on shadow maps
-			createInfoSampler.compareOp = VK_COMPARE_OP_ALWAYS;
-
-			createInfoSampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-			createInfoSampler.mipLodBias = 0.0f;
-			createInfoSampler.minLod = 0.0f;
-			createInfoSampler.maxLod = static_cast<float>(mipLevels);
-
-
-			if (vkCreateSampler(vkDevice, &createInfoSampler, nullptr, &textureSampler) != VK_SUCCESS)
-			{
-				throw std::runtime_error("Failed to create texture sampler!");
-			}
-		}
-
-		/*
-		* Load model
-		*/
-		void LoadModel(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, const std::string& modelPath)
-		{
-			tinyobj::attrib_t attrib;
-			std::vector<tinyobj::shape_t> shapes;
-			std::vector<tinyobj::material_t> materials;
-
-			std::string warn, err;
-			if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, modelPath.c_str()))
-			{
-				throw std::runtime_error(warn + err);
-			}
-
-			// combined indices/vertex map to filter non-unique verts
-			std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-
-			for (const auto& shape : shapes)
-			{
-				for (const auto& index : shape.mesh.indices)
+				if (Memory::Budget().GetPropertyFlags(imageMemory) & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
 				{
-					Vertex vertex{};
-
-					vertex.pos = 
-					{
-						attrib.vertices[3 * index.vertex_index + 0],
-						attrib.vertices[3 * index.vertex_index + 1],
-						attrib.vertices[3 * index.vertex_index + 2]
-					};
-
-					// centered
-					//vertex.texCoord = 
-					//{
-					//	attrib.texcoords[2 * index.texcoord_index + 0],
-					//	attrib.texcoords[2 * index.texcoord_index + 1]
-					//};
-
-					// offset to account for the model
-					vertex.texCoord = 
-					{
-						attrib.texcoords[2 * index.texcoord_index + 0],
-						1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-					};
-
-					vertex.color = { 1.0f, 1.0f, 1.0f };
-
-					if (uniqueVertices.count(vertex) == 0)
-					{
-						uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-						vertices.push_back(vertex);
-					}
-
-					indices.push_back(uniqueVertices[vertex]);
+					VkDeviceSize imageCommittedBytes = 0;
+					vkGetDeviceMemoryCommitment(vkDevice, imageMemory, &imageCommittedBytes);
+					committedBytes += imageCommittedBytes;
+					bLazilyAllocated = true;
+				}
+				else
+				{
+					committedBytes += memoryRequirements.size;
 				}
 			}
+
+			SDL_Log("Window %u attachments %ux%u: %.1f MiB, %.1f MiB committed (%s), saving %.1f MiB",
+				sdlWindowId, swapChainExtent.width, swapChainExtent.height,
+				attachmentBytes / (1024.0 * 1024.0), committedBytes / (1024.0 * 1024.0),
+				bLazilyAllocated ? "lazily allocated" : "no lazily allocated memory on this device",
+				(attachmentBytes - committedBytes) / (1024.0 * 1024.0));
 		}
 
 		/*
-		* Initialize Vertex Buffer
+		* Initialize Depth Buffer Resources
 		*/
-		void InitVertexBuffer(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
+		void InitDepthBufferResources(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, VkSampleCountFlagBits numSamples, AttachmentPool& _attachmentPool)
 		{
-			VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-
-			// Staging buffer which can have data accessable via CPU
-			VkBuffer stagingBuffer;
-			VkDeviceMemory stagingBufferMemory;
-			CreateBuffer(
-				vkDevice,
-				vkPhysicalDevice,
-				bufferSize,
-				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				stagingBuffer,
-				stagingBufferMemory
-			);
+			attachmentPool = &_attachmentPool;
 
-			// MAP BUFFER MEMORY
-
-			/*
-			* Unfortunately the driver may not immediately copy the data into the buffer memory,
-			*	for example because of caching. It is also possible that writes to the buffer are not
-			*	visible in the mapped memory yet. There are two ways to deal with that problem:
-			*
-			*		- Use a memory heap that is host coherent, indicated with VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-			*		- Call vkFlushMappedMemoryRanges after writing to the mapped memory,
-			*			and call vkInvalidateMappedMemoryRanges before reading from the mapped memory
-			*
-			* Chosen approach below uses first method, may lead to slightly worse performance than explicit flushing
-			*/
-			void* bufferData;
-			vkMapMemory(vkDevice, stagingBufferMemory, 0, bufferSize, 0, &bufferData);
-			memcpy(bufferData, vertices.data(), (size_t)bufferSize);
-			vkUnmapMemory(vkDevice, stagingBufferMemory);
-
-			// Vertex buffer where its memory is GPU only and updated via the staging buffer
-			CreateBuffer(
+			VkFormat depthFormat = GetDepthFormat(vkPhysicalDevice);
+			depthAttachment = attachmentPool->Acquire
+			(
 				vkDevice,
 				vkPhysicalDevice,
-				bufferSize,
-				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				vkVertexBuffer,
-				vkVertexBufferMemory
+				swapChainExtent.width,
+				swapChainExtent.height,
+				numSamples,
+				depthFormat,
+				VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, // cleared on load, never stored
+				VK_IMAGE_ASPECT_DEPTH_BIT,
+				DEPTH_ALIAS_GROUP
 			);
 
-			// transfer from staging over to gpu vertex buffer
-			CopyBufferData(vkDevice, stagingBuffer, vkVertexBuffer, bufferSize);
-
-			// cleanup staging buffer
-			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
-			vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
+			// no explicit transition, the render pass takes it from UNDEFINED and waiting on the queue here would stall every window
 		}
 
 		/*
-		* Initialize Index Buffer
+		* Acquire the mesh and texture this window draws, shared with every other window using the same files
 		*/
-		void InitIndexBuffer(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
+		void InitResources(ResourceManager& resourceManager, const std::string& modelPath, const std::string& texturePath)
 		{
-			VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-
-			VkBuffer stagingBuffer;
-			VkDeviceMemory stagingBufferMemory;
-			CreateBuffer
-			(
-				vkDevice,
-				vkPhysicalDevice,
-				bufferSize,
-				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				stagingBuffer,
-				stagingBufferMemory
-			);
-
-			void* data;
-			vkMapMemory(vkDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
-			memcpy(data, indices.data(), (size_t)bufferSize);
-			vkUnmapMemory(vkDevice, stagingBufferMemory);
-
-			CreateBuffer
-			(
-				vkDevice,
-				vkPhysicalDevice,
-				bufferSize,
-				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				vkIndexBuffer,
-				vkIndexBufferMemory
-			);
-
-			CopyBufferData(vkDevice, stagingBuffer, vkIndexBuffer, bufferSize);
-
-			vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
-			vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
+			meshHandle = resourceManager.AcquireMesh(modelPath);
+			textureHandle = resourceManager.AcquireTexture(texturePath);
 		}
 
 		/*
@@ -1593,21 +694,23 @@ namespace Vigor
 		{
 			VkDeviceSize bufferSize = sizeof(ModelViewProjectionBuffer);
 
-			uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-			uniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
-			uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
+			uniformBuffers.resize(frameProfile.framesInFlight);
+			uniformBuffersMemory.resize(frameProfile.framesInFlight);
+			uniformBuffersMapped.resize(frameProfile.framesInFlight);
 
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+			for (size_t i = 0; i < frameProfile.framesInFlight; i++)
 			{
-				CreateBuffer
+				Memory::CreateBuffer
 				(
 					vkDevice,
 					vkPhysicalDevice,
 					bufferSize,
-					VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+					VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | descriptorBackend->GetRequiredBufferUsage(),
+					MemoryUsage::Dynamic,
 					uniformBuffers[i],
-					uniformBuffersMemory[i]
+					uniformBuffersMemory[i],
+					MemoryCategory::Uniform,
+					descriptorBackend->GetRequiredAllocateFlags()
 				);
 				vkMapMemory(vkDevice, uniformBuffersMemory[i], 0, bufferSize, 0, &uniformBuffersMapped[i]);
 			}
@@ -1618,22 +721,7 @@ namespace Vigor
 		*/
 		void InitDescriptorPool(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
 		{
-			std::array<VkDescriptorPoolSize, 2> poolSizes{};
-			poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-			poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-
-			VkDescriptorPoolCreateInfo createInfoDescriptorPool{};
-			createInfoDescriptorPool.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-			createInfoDescriptorPool.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-			createInfoDescriptorPool.pPoolSizes = poolSizes.data();
-			createInfoDescriptorPool.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-
-			if (vkCreateDescriptorPool(vkDevice, &createInfoDescriptorPool, nullptr, &descriptorPool) != VK_SUCCESS)
-			{
-				throw std::runtime_error("failed to create descriptor pool!");
-			}
+			descriptorBackend->InitPool(vkDevice, frameProfile.framesInFlight);
 		}
 
 		/*
@@ -1641,73 +729,66 @@ namespace Vigor
 		*/
 		void InitDescriptorSets(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice)
 		{
-			std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
-
-			VkDescriptorSetAllocateInfo allocInfoDescriptorSet{};
-			allocInfoDescriptorSet.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			allocInfoDescriptorSet.descriptorPool = descriptorPool;
-			allocInfoDescriptorSet.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-			allocInfoDescriptorSet.pSetLayouts = layouts.data();
-
-			descriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
-			if (vkAllocateDescriptorSets(vkDevice, &allocInfoDescriptorSet, descriptorSets.data()) != VK_SUCCESS)
-			{
-				throw std::runtime_error("failed to allocate descriptor sets!");
-			}
-
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+			for (uint32_t i = 0; i < frameProfile.framesInFlight; i++)
 			{
 				VkDescriptorBufferInfo bufferInfo{};
 				bufferInfo.buffer = uniformBuffers[i];
 				bufferInfo.offset = 0;
 				bufferInfo.range = sizeof(ModelViewProjectionBuffer);
 
-				VkDescriptorImageInfo imageInfo{};
-				imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-				imageInfo.imageView = textureImageView;
-				imageInfo.sampler = textureSampler;
-
-				std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[0].dstSet = descriptorSets[i];
-				descriptorWrites[0].dstBinding = 0;
-				descriptorWrites[0].dstArrayElement = 0;
-				descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				descriptorWrites[0].descriptorCount = 1;
-				descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-				descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[1].dstSet = descriptorSets[i];
-				descriptorWrites[1].dstBinding = 1;
-				descriptorWrites[1].dstArrayElement = 0;
-				descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-				descriptorWrites[1].descriptorCount = 1;
-				descriptorWrites[1].pImageInfo = &imageInfo;
-
-				vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+				descriptorBackend->WriteUniformBuffer(vkDevice, i, 0, bufferInfo);
 			}
 		}
 
 		// Runtime
-		void DrawFrame(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, SwapChainSupportDetails swapChainSupportDetails, QueueFamilyIndicies queueFamilyIndicies, VkSampleCountFlagBits numSamples)
+		void DrawFrame(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, SwapChainSupportDetails swapChainSupportDetails, QueueFamilyIndicies queueFamilyIndicies, VkSampleCountFlagBits numSamples, const BindlessTextureTable& textureTable, ResourceManager& resourceManager)
 		{
+			WaitForPresent(vkDevice);
+
 			vkWaitForFences(vkDevice, 1, &frameData.inFlightFences[currentFrame], VK_TRUE, UINT64_MAX); // wait for previous frame to finish
 
+			descriptorBackend->ResetTransient(vkDevice, currentFrame); // per draw sets of this frame slot are no longer in use
+
+			RetireSwapChains(vkDevice, false);
+
+			// resize events since the last frame are coalesced into this one recreation
+			if (bFrameBufferResized)
+			{
+				if (!ReInitSwapChain(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies, numSamples))
+				{
+					return; // zero sized, try again once the window has an area
+				}
+			}
+
+			// late acquire does the frame's CPU work first, the image is then only held from recording to present
+			ModelViewProjectionBuffer mvpBuffer{};
+			if (frameProfile.bLateAcquire)
+			{
+				mvpBuffer = UpdateConstantBuffer(currentFrame);
+			}
+
 			// TODO
 			uint32_t imageIdx = 0;
 			VkResult aquireNextImageRes = vkAcquireNextImageKHR(vkDevice, swapChain, UINT64_MAX, frameData.imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIdx);
 
 			if (aquireNextImageRes == VK_ERROR_OUT_OF_DATE_KHR)
 			{
-				ReInitSwapChain(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies, numSamples);
+				bFrameBufferResized = true; // nothing was acquired, recreate next frame
 				return;
 			}
+			else if (aquireNextImageRes == VK_SUBOPTIMAL_KHR)
+			{
+				bFrameBufferResized = true; // the image is still presentable, draw it and recreate next frame
+			}
 			else if (aquireNextImageRes != VK_SUCCESS)
 			{
 				throw std::runtime_error("Failed to acquire swap chain image!");
 			}
 
-			UpdateConstantBuffer(currentFrame);
+			if (!frameProfile.bLateAcquire)
+			{
+				mvpBuffer = UpdateConstantBuffer(currentFrame);
+			}
 
 			vkResetFences(vkDevice, 1, &frameData.inFlightFences[currentFrame]);
 
@@ -1744,9 +825,34 @@ namespace Vigor
 				beginInfoRenderPass.clearValueCount = static_cast<uint32_t>(clearValues.size());
 				beginInfoRenderPass.pClearValues = clearValues.data();
 
-				vkCmdBeginRenderPass(commandBuffer, &beginInfoRenderPass, VK_SUBPASS_CONTENTS_INLINE);
+				// swap in the full quality pipeline (and later its optimized link) the moment it is ready, skip drawing if not even the fallback is
+				VkPipeline boundPipeline = graphicsPipeline->Get();
+				if (boundPipeline == VK_NULL_HANDLE)
+				{
+					boundPipeline = fallbackPipeline->Get();
+				}
+
+				// shared resources resolve through their handles, a released one just isn't drawn
+				const MeshResource* mesh = resourceManager.GetMesh(meshHandle);
+				const TextureResource* texture = resourceManager.GetTexture(textureHandle);
+
+				if (mesh != nullptr)
+				{
+					resourceManager.ReportTextureUsage(textureHandle, ProjectedDiameterPixels(*mesh, mvpBuffer));
+				}
+
+				if (renderPass != VK_NULL_HANDLE)
+				{
+					vkCmdBeginRenderPass(commandBuffer, &beginInfoRenderPass, VK_SUBPASS_CONTENTS_INLINE);
+				}
+				else
+				{
+					BeginDynamicRendering(commandBuffer, imageIdx, numSamples, clearValues);
+				}
+
+				if (boundPipeline != VK_NULL_HANDLE && mesh != nullptr && texture != nullptr)
 				{
-					vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+					vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline);
 
 					// Setup viewport dynamic
 					VkViewport viewport{};
@@ -1765,35 +871,37 @@ namespace Vigor
 					vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
 					// Bind Vertex Buffers
-					VkBuffer vertexBuffers[] = { vkVertexBuffer };
+					VkBuffer vertexBuffers[] = { mesh->vertexBuffer };
 					VkDeviceSize offsets[] = { 0 };
 
 					vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-					vkCmdBindIndexBuffer(commandBuffer, vkIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+					vkCmdBindIndexBuffer(commandBuffer, mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-					vkCmdBindDescriptorSets
-					(
-						commandBuffer,
-						VK_PIPELINE_BIND_POINT_GRAPHICS,
-						pipelineLayout,
-						0,
-						1,
-						&descriptorSets[currentFrame],
-						0,
-						nullptr
-					);
+					// set 0 per frame uniforms, set 1 global texture table
+					descriptorBackend->Bind(commandBuffer, pipelineLayout, currentFrame, textureTable);
+
+					DrawPushConstants drawPushConstants{};
+					drawPushConstants.materialIndex = texture->textureSlot;
+					vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(DrawPushConstants), &drawPushConstants);
 
 					vkCmdDrawIndexed
 					(
 						commandBuffer,
-						static_cast<uint32_t>(indices.size()), // idx count
+						mesh->indexCount, // idx count
 						1, // instance count
 						0, // first idx
 						0, // vert offset
 						0 // first instance
 					);
 				}
-				vkCmdEndRenderPass(commandBuffer);
+				if (renderPass != VK_NULL_HANDLE)
+				{
+					vkCmdEndRenderPass(commandBuffer);
+				}
+				else
+				{
+					EndDynamicRendering(commandBuffer, imageIdx);
+				}
 
 				VkResult endCommandBufferRes = vkEndCommandBuffer(commandBuffer);
 				if (endCommandBufferRes != VK_SUCCESS)
@@ -1815,7 +923,7 @@ namespace Vigor
 			submitInfo.commandBufferCount = 1;
 			submitInfo.pCommandBuffers = &frameData.commandBuffers[currentFrame];
 
-			VkSemaphore signalSemaphores[] = { frameData.renderFinishedSemaphores[currentFrame] };
+			VkSemaphore signalSemaphores[] = { frameData.renderFinishedSemaphores[imageIdx] };
 			submitInfo.signalSemaphoreCount = 1;
 			submitInfo.pSignalSemaphores = signalSemaphores;
 
@@ -1824,6 +932,8 @@ namespace Vigor
 				throw std::runtime_error("Failed to submit command buffer draw!");
 			}
 
+			frameNumber++;
+
 			VkPresentInfoKHR presentInfo{};
 			presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 			presentInfo.waitSemaphoreCount = 1;
@@ -1836,35 +946,132 @@ namespace Vigor
 
 			presentInfo.pResults = nullptr; // specify an array of VkResult values to check for every individual swap chain if presentation was successful
 
+			VkPresentIdKHR presentIdInfo{};
+			if (vkWaitForPresentKHR != nullptr)
+			{
+				presentId++;
+
+				presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+				presentIdInfo.swapchainCount = 1;
+				presentIdInfo.pPresentIds = &presentId;
+
+				presentInfo.pNext = &presentIdInfo;
+			}
+
 			VkResult presentResult = vkQueuePresentKHR(presentQueue, &presentInfo);
-			if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || bFrameBufferResized)
+			if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR)
 			{
-				bFrameBufferResized = false;
-				ReInitSwapChain(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies, numSamples);
+				bFrameBufferResized = true; // picked up at the start of the next frame
 			}
 			else if (presentResult != VK_SUCCESS)
 			{
 				throw std::runtime_error("Failed to acquire swap chain image!");
 			}
 
-			currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT; // set current frame counter to loop when max reached
+			currentFrame = (currentFrame + 1) % frameProfile.framesInFlight; // set current frame counter to loop when max reached
 		}
 
-		void CopyBufferData(VkDevice vkDevice, VkBuffer srcBuff, VkBuffer dstBuff, VkDeviceSize size)
+		/*
+		* The render pass's work without one: attachments are moved into their layouts by hand, MSAA color resolves
+		*	into the swapchain image, and the external dependency becomes the barrier's first scope
+		*/
+		void BeginDynamicRendering(VkCommandBuffer commandBuffer, uint32_t imageIdx, VkSampleCountFlagBits numSamples, const std::array<VkClearValue, 2>& clearValues)
 		{
-			VkCommandBuffer commandBuffer = BeginOneTimeCommands(vkDevice, frameData);
+			bool bStencil = Images::FormatHasStencilComponent(depthAttachment.format);
+			bool bResolve = numSamples != VK_SAMPLE_COUNT_1_BIT;
+
+			// contents are never kept, every transition is from UNDEFINED
+			std::array<VkImageMemoryBarrier, 3> barriers{};
+			for (VkImageMemoryBarrier& barrier : barriers)
+			{
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			}
+
+			// the acquire semaphore is waited at color output, nothing to wait on beyond it
+			barriers[0].image = swapChainImages[imageIdx];
+			barriers[0].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			barriers[0].srcAccessMask = 0;
+			barriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			// pooled attachments may have been written by another window or frame, order after those writes
+			barriers[1].image = colorAttachment.image;
+			barriers[1].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			barriers[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			barriers[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			barriers[2].image = depthAttachment.image;
+			barriers[2].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			barriers[2].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			barriers[2].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			barriers[2].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | (bStencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+
+			VkPipelineStageFlags attachmentStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			vkCmdPipelineBarrier(commandBuffer, attachmentStages, attachmentStages, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+			VkRenderingAttachmentInfo colorAttachmentInfo{};
+			colorAttachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+			colorAttachmentInfo.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			colorAttachmentInfo.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			colorAttachmentInfo.clearValue = clearValues[0];
+			if (bResolve)
+			{
+				colorAttachmentInfo.imageView = colorAttachment.imageView;
+				colorAttachmentInfo.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // only the resolve is kept
+				colorAttachmentInfo.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+				colorAttachmentInfo.resolveImageView = swapChainImageViews[imageIdx];
+				colorAttachmentInfo.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			}
+			else
+			{
+				colorAttachmentInfo.imageView = swapChainImageViews[imageIdx];
+				colorAttachmentInfo.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			}
 
-			// Do the copy
-			VkBufferCopy copyBufferRegion{};
-			copyBufferRegion.srcOffset = 0; // Optional
-			copyBufferRegion.dstOffset = 0; // Optional
-			copyBufferRegion.size = size;
-			vkCmdCopyBuffer(commandBuffer, srcBuff, dstBuff, 1, &copyBufferRegion);
+			VkRenderingAttachmentInfo depthAttachmentInfo{};
+			depthAttachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+			depthAttachmentInfo.imageView = depthAttachment.imageView;
+			depthAttachmentInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			depthAttachmentInfo.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			depthAttachmentInfo.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			depthAttachmentInfo.clearValue = clearValues[1];
+
+			VkRenderingInfo renderingInfo{};
+			renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+			renderingInfo.renderArea.offset = { 0, 0 };
+			renderingInfo.renderArea.extent = swapChainExtent;
+			renderingInfo.layerCount = 1;
+			renderingInfo.colorAttachmentCount = 1;
+			renderingInfo.pColorAttachments = &colorAttachmentInfo;
+			renderingInfo.pDepthAttachment = &depthAttachmentInfo;
+			renderingInfo.pStencilAttachment = bStencil ? &depthAttachmentInfo : nullptr;
+
+			vkCmdBeginRendering(commandBuffer, &renderingInfo);
+		}
 
-			EndOneTimeCommands(vkDevice, graphicsQueue, frameData, commandBuffer);
+		void EndDynamicRendering(VkCommandBuffer commandBuffer, uint32_t imageIdx)
+		{
+			vkCmdEndRendering(commandBuffer);
+
+			// the render pass's finalLayout, the present waits on the render finished semaphore
+			VkImageMemoryBarrier presentBarrier{};
+			presentBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			presentBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			presentBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+			presentBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			presentBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			presentBarrier.image = swapChainImages[imageIdx];
+			presentBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			presentBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			presentBarrier.dstAccessMask = 0;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &presentBarrier);
 		}
 
-		void UpdateConstantBuffer(uint32_t currentFrame)
+		ModelViewProjectionBuffer UpdateConstantBuffer(uint32_t currentFrame)
 		{
 			static auto startTime = std::chrono::high_resolution_clock::now();
 
@@ -1883,73 +1090,138 @@ namespace Vigor
 			mvpBuffer.Projection[1][1] *= -1; // adjust clip co-ordinates
 
 			memcpy(uniformBuffersMapped[currentFrame], &mvpBuffer, sizeof(mvpBuffer));
+
+			return mvpBuffer;
 		}
 
-		// Shutdown
-		void Shutdown(VkInstance vkInstance, VkDevice vkDevice)
+		/*
+		* How many pixels tall the mesh's bounding sphere is on screen, the texture streaming feedback
+		*/
+		float ProjectedDiameterPixels(const MeshResource& mesh, const ModelViewProjectionBuffer& mvpBuffer) const
 		{
-			ShutdownSwapChain(vkDevice);
+			glm::vec4 viewCenter = mvpBuffer.View * mvpBuffer.Model * glm::vec4(mesh.boundsCenter, 1.0f);
+			float viewDepth = std::max(-viewCenter.z, 0.1f); // clamped to the near plane, the camera may be inside the bounds
 
-			vkDestroySampler(vkDevice, textureSampler, nullptr);
-			vkDestroyImageView(vkDevice, textureImageView, nullptr);
+			// Projection[1][1] is cot(fovy / 2), flipped for Vulkan's clip space
+			return mesh.boundsRadius * std::abs(mvpBuffer.Projection[1][1]) / viewDepth * swapChainExtent.height;
+		}
 
-			vkDestroyImage(vkDevice, textureImage, nullptr);
-			vkFreeMemory(vkDevice, textureImageMemory, nullptr);
+		// Shutdown
+		void Shutdown(VkInstance vkInstance, VkDevice vkDevice, ResourceManager& resourceManager, PipelineRegistry& pipelineRegistry)
+		{
+			WaitForFrames(vkDevice);
 
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-			{
-				vkDestroyBuffer(vkDevice, uniformBuffers[i], nullptr);
-				vkFreeMemory(vkDevice, uniformBuffersMemory[i], nullptr);
-			}
+			ShutdownSwapChain(vkDevice);
 
-			vkDestroyDescriptorPool(vkDevice, descriptorPool, nullptr);
-			vkDestroyDescriptorSetLayout(vkDevice, descriptorSetLayout, nullptr);
+			// the last window to let go frees the GPU copy
+			resourceManager.Release(textureHandle);
+			resourceManager.Release(meshHandle);
 
-			vkDestroyBuffer(vkDevice, vkIndexBuffer, nullptr);
-			vkFreeMemory(vkDevice, vkIndexBufferMemory, nullptr);
+			ShutdownFrameResources(vkDevice);
 
-			vkDestroyBuffer(vkDevice, vkVertexBuffer, nullptr);
-			vkFreeMemory(vkDevice, vkVertexBufferMemory, nullptr);
+			// pipelines, their layout and the render pass belong to the engine's registry
+			graphicsPipeline.reset();
+			fallbackPipeline.reset();
 
-			vkDestroyPipeline(vkDevice, graphicsPipeline, nullptr);
-			vkDestroyPipelineLayout(vkDevice, pipelineLayout, nullptr);
-			vkDestroyRenderPass(vkDevice, renderPass, nullptr);
+			pipelineLayout = VK_NULL_HANDLE;
+			pipelineRegistry.ReleaseRenderPass(renderPass);
+			renderPass = VK_NULL_HANDLE;
 
 			frameData.Shutdown(vkDevice);
 
 			vkDestroySurfaceKHR(vkInstance, surface, nullptr);
 		}
 
-		void ShutdownSwapChain(VkDevice vkDevice)
+		/*
+		* Everything sized by the frame profile: uniform buffers, descriptors, command buffers and sync objects.
+		*	Waits on this window's frames only, the others keep drawing
+		*/
+		void ShutdownFrameResources(VkDevice vkDevice)
 		{
-			// multisampling color cleanup
-			vkDestroyImageView(vkDevice, colorImageView, nullptr);
-			vkDestroyImage(vkDevice, colorImage, nullptr);
-			vkFreeMemory(vkDevice, colorImageMemory, nullptr);
+			WaitForFrames(vkDevice);
 
-			// depth buffer cleanup
-			vkDestroyImageView(vkDevice, depthImageView, nullptr);
-			vkDestroyImage(vkDevice, depthImage, nullptr);
-			vkFreeMemory(vkDevice, depthImageMemory, nullptr);
+			// the fences only cover the submits, queued presents may still wait on their semaphores. Profile switches are rare,
+			//	the present queue draining once is cheaper than tracking each present
+			vkQueueWaitIdle(presentQueue);
+			RetireSwapChains(vkDevice, true); // stamped against the old frame count
 
-			for (auto framebuffer : swapChainFramebuffers)
+			for (size_t i = 0; i < uniformBuffers.size(); i++)
 			{
-				vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
+				vkDestroyBuffer(vkDevice, uniformBuffers[i], nullptr);
+				Memory::FreeMemory(vkDevice, uniformBuffersMemory[i]);
 			}
 
-			for (auto imageView : swapChainImageViews)
+			uniformBuffers.clear();
+			uniformBuffersMemory.clear();
+			uniformBuffersMapped.clear();
+
+			if (descriptorBackend)
 			{
-				vkDestroyImageView(vkDevice, imageView, nullptr);
+				descriptorBackend->Shutdown(vkDevice);
+				descriptorBackend.reset();
 			}
 
-			vkDestroySwapchainKHR(vkDevice, swapChain, nullptr);
+			frameData.ShutdownFrames(vkDevice);
+		}
+
+		/*
+		* !! NOTE !! the GPU must be done with this window's frames
+		*/
+		void ShutdownSwapChain(VkDevice vkDevice)
+		{
+			RetireSwapChains(vkDevice, true);
+
+			RetiredSwapChain current = DetachSwapChain();
+			DestroySwapChain(vkDevice, current);
 		}
 
 	private:
 		/*
-		* Re-initialize swapchains for events that invalidate them like window resize
+		* FIFO modes only: hold the frame back until the present before last is on screen, at most one image then waits
+		*	in the queue and the frame is started against the display's timing instead of however far ahead the CPU got.
+		*	Mailbox and immediate never block the GPU, they are capped by the engine's FrameLimiter if at all
+		*/
+		void WaitForPresent(VkDevice vkDevice)
+		{
+			constexpr uint64_t presentWaitTimeout = 100'000'000; // ns, an occluded window may not present at all
+
+			if (vkWaitForPresentKHR == nullptr || (presentMode != VK_PRESENT_MODE_FIFO_KHR && presentMode != VK_PRESENT_MODE_FIFO_RELAXED_KHR))
+			{
+				return;
+			}
+
+			if (presentId < swapChainFirstPresentId + 1)
+			{
+				return; // nothing presented on this swapchain before the last one
+			}
+
+			// a timeout or out of date swapchain is not an error here, the acquire will see the latter
+			vkWaitForPresentKHR(vkDevice, swapChain, presentId - 1, presentWaitTimeout);
+		}
+
+		void WaitForFrames(VkDevice vkDevice)
+		{
+			if (!frameData.inFlightFences.empty())
+			{
+				vkWaitForFences(vkDevice, static_cast<uint32_t>(frameData.inFlightFences.size()), frameData.inFlightFences.data(), VK_TRUE, UINT64_MAX);
+			}
+		}
+
+		struct RetiredSwapChain
+		{
+			uint64_t frameNumber; // frames submitted before it was replaced, the last of them may use it
+			VkSwapchainKHR swapChain;
+			std::vector<VkImageView> imageViews;
+			std::vector<VkFramebuffer> framebuffers;
+			std::vector<VkSemaphore> renderFinishedSemaphores; // its last presents may still wait on them
+			PooledAttachment colorAttachment;
+			PooledAttachment depthAttachment;
+		};
+
+		/*
+		* Re-initialize swapchains for events that invalidate them like window resize, false while the window has no area
 		*/
-		void ReInitSwapChain(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, SwapChainSupportDetails swapChainSupportDetails, QueueFamilyIndicies queueFamilyIndicies, VkSampleCountFlagBits numSamples)
+		bool ReInitSwapChain(VkDevice vkDevice, VkPhysicalDevice vkPhysicalDevice, SwapChainSupportDetails swapChainSupportDetails, QueueFamilyIndicies queueFamilyIndicies, VkSampleCountFlagBits numSamples)
 		{
 			/* !! NOTE !!
 			* we don't recreate the renderpass here for simplicity.
@@ -1959,17 +1231,92 @@ namespace Vigor
 			* 	between dynamic ranges is properly reflected.
 			*/
 
-			vkDeviceWaitIdle(vkDevice);
+			// the support details were queried at startup, the extent has changed since
+			vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkPhysicalDevice, surface, &swapChainSupportDetails.capabilities);
+			if (swapChainSupportDetails.capabilities.currentExtent.width == 0 || swapChainSupportDetails.capabilities.currentExtent.height == 0)
+			{
+				return false;
+			}
 
-			ShutdownSwapChain(vkDevice);
+			bFrameBufferResized = false;
 
-			InitSwapChain(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies);
+			/* -- NOTE --
+			* No device wide idle. The old swapchain is handed to the new one and everything built on it is retired,
+			*	then destroyed once the frames already submitted against it have completed. Other windows keep drawing.
+			*/
+			retiredSwapChains.push_back(DetachSwapChain());
+
+			InitSwapChain(vkDevice, vkPhysicalDevice, swapChainSupportDetails, queueFamilyIndicies, retiredSwapChains.back().swapChain);
 			InitImageViews(vkDevice);
 
-			InitColorResources(vkDevice, vkPhysicalDevice, numSamples);
-			InitDepthBufferResources(vkDevice, vkPhysicalDevice, numSamples);
+			InitColorResources(vkDevice, vkPhysicalDevice, numSamples, *attachmentPool);
+			InitDepthBufferResources(vkDevice, vkPhysicalDevice, numSamples, *attachmentPool);
 
 			InitFrameBuffers(vkDevice);
+
+			return true;
+		}
+
+		/*
+		* Move the swapchain and everything built on it out of the window, stamped with the frames submitted so far
+		*/
+		RetiredSwapChain DetachSwapChain()
+		{
+			RetiredSwapChain retired{};
+			retired.frameNumber = frameNumber;
+			retired.swapChain = swapChain;
+			retired.imageViews = std::move(swapChainImageViews);
+			retired.framebuffers = std::move(swapChainFramebuffers);
+			retired.renderFinishedSemaphores = std::move(frameData.renderFinishedSemaphores);
+			retired.colorAttachment = colorAttachment;
+			retired.depthAttachment = depthAttachment;
+
+			swapChain = VK_NULL_HANDLE;
+			swapChainImages.clear();
+			swapChainImageViews.clear();
+			swapChainFramebuffers.clear();
+			frameData.renderFinishedSemaphores.clear();
+			colorAttachment = PooledAttachment{};
+			depthAttachment = PooledAttachment{};
+
+			return retired;
+		}
+
+		void DestroySwapChain(VkDevice vkDevice, RetiredSwapChain& retired)
+		{
+			// multisampling color and depth go back to the pool, their memory is kept for the next swapchain
+			attachmentPool->Release(vkDevice, retired.colorAttachment);
+			attachmentPool->Release(vkDevice, retired.depthAttachment);
+
+			for (auto framebuffer : retired.framebuffers)
+			{
+				vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
+			}
+
+			for (auto imageView : retired.imageViews)
+			{
+				vkDestroyImageView(vkDevice, imageView, nullptr);
+			}
+
+			for (auto semaphore : retired.renderFinishedSemaphores)
+			{
+				vkDestroySemaphore(vkDevice, semaphore, nullptr);
+			}
+
+			vkDestroySwapchainKHR(vkDevice, retired.swapChain, nullptr);
+		}
+
+		/*
+		* Destroy retired swapchains whose frames have all completed, or every one of them when bAll.
+		*	Called after waiting on the current frame slot's fence, by then every frame but the last framesInFlight - 1 is done
+		*/
+		void RetireSwapChains(VkDevice vkDevice, bool bAll)
+		{
+			while (!retiredSwapChains.empty() && (bAll || retiredSwapChains.front().frameNumber + frameProfile.framesInFlight <= frameNumber))
+			{
+				DestroySwapChain(vkDevice, retiredSwapChains.front());
+				retiredSwapChains.pop_front();
+			}
 		}
 
 	public:
@@ -2007,63 +1354,44 @@ namespace Vigor
 		// Render Pass and Pipelines - TODO[CC] Enable multiple/re-use
 		VkRenderPass renderPass;
 
-		VkPipeline graphicsPipeline;
+		std::shared_ptr<AsyncPipeline> graphicsPipeline; // full quality, built in the background
+		std::shared_ptr<AsyncPipeline> fallbackPipeline; // cheaper variant drawn with until graphicsPipeline is ready
 		VkPipelineLayout pipelineLayout;
 
 		// Frame Data - TODO[CC] Enable multiple
 		FrameData frameData;
-		uint32_t currentFrame = 0;
-		bool bFrameBufferResized = false;
-
-		// Dynamic states for window
-		std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		FrameProfile frameProfile;
+		PresentPolicy presentPolicy = PresentPolicy::Mailbox;
+		VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; // what the swapchain was created with
 
-		// TODO[CC] these are here for in-dev, create functionality to collect verts and attr's from "imported" meshes etc. for the scene to display
-		std::vector<Vertex> vertices;
+		// VK_KHR_present_wait, null when unsupported
+		PFN_vkWaitForPresentKHR vkWaitForPresentKHR = nullptr;
+		uint64_t presentId = 0; // last id presented, monotonic across swapchains
+		uint64_t swapChainFirstPresentId = 1;
 
-		// contents of index buffer
-		std::vector<uint32_t> indices;
+		uint32_t currentFrame = 0;
+		uint64_t frameNumber = 0; // frames submitted
+		bool bFrameBufferResized = false; // set by resize events and suboptimal presents, acted on once per frame
 
-		// TODO[CC] support multiple
-		VkBuffer vkVertexBuffer;
-		VkDeviceMemory vkVertexBufferMemory;
+		std::deque<RetiredSwapChain> retiredSwapChains; // replaced by a resize, waiting on their frames
 
-		VkBuffer vkIndexBuffer;
-		VkDeviceMemory vkIndexBufferMemory;
-
-		/* !! NOTE !!
-		* the memory type that allows us to access it from the CPU may not be the most optimal memory type for the graphics card
-		*	to read from. The most optimal memory has the VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT flag and is usually not accessible
-		*	by the CPU on dedicated graphics cards. In this chapter we're going to create two vertex buffers.
-		*	One staging buffer in CPU accessible memory to upload the data from the vertex array to, and the final vertex buffer
-		*	in device local memory. We'll then use a buffer copy command to move the data from the staging buffer to the actual
-		*	vertex buffer.
-		*/
+		// TODO[CC] support multiple, owned by the engine's resource manager
+		MeshHandle meshHandle;
+		TextureHandle textureHandle;
 
 		std::vector<VkBuffer> uniformBuffers;
 		std::vector<VkDeviceMemory> uniformBuffersMemory;
 		std::vector<void*> uniformBuffersMapped;
 
-		// Texture sampling
-		uint32_t mipLevels;
-		VkImage textureImage;
-		VkDeviceMemory textureImageMemory;
-		VkImageView textureImageView;
-		VkSampler textureSampler;
-
 		// Depth Buffering
-		VkImage depthImage;
-		VkDeviceMemory depthImageMemory;
-		VkImageView depthImageView;
+		PooledAttachment depthAttachment;
 
 		// Descriptor data
-		VkDescriptorPool descriptorPool;
-		std::vector<VkDescriptorSet> descriptorSets;
-		VkDescriptorSetLayout descriptorSetLayout;
+		std::unique_ptr<DescriptorBackend> descriptorBackend; // set 0 - pooled sets, push descriptors or descriptor buffer
 
 		// multisampling
-		VkImage colorImage;
-		VkDeviceMemory colorImageMemory;
-		VkImageView colorImageView;
+		PooledAttachment colorAttachment;
+
+		AttachmentPool* attachmentPool; // owned by the engine
 	};
 }
\ No newline at end of file
@@ -1,6 +1,19 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(binding = 1) uniform sampler2D texSampler;
+// engine wide bindless texture table
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// per pipeline variant switches, see Vigor::ShaderFeatures
+layout(constant_id = 0) const bool USE_VERTEX_COLOR = true;
+layout(constant_id = 1) const bool USE_TEXTURE = true;
+layout(constant_id = 2) const bool USE_ALPHA_TEST = false;
+
+const float ALPHA_CUTOFF = 0.5;
+
+layout(push_constant) uniform DrawPushConstants {
+	uint materialIndex;
+} draw;
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
@@ -8,5 +21,19 @@ layout(location = 1) in vec2 fragTexCoord;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-	outColor = vec4(fragColor * texture(texSampler, fragTexCoord).rgb, 1.0);
+	vec4 color = vec4(1.0);
+
+	if (USE_TEXTURE) {
+		color = texture(textures[nonuniformEXT(draw.materialIndex)], fragTexCoord);
+	}
+
+	if (USE_VERTEX_COLOR) {
+		color.rgb *= fragColor;
+	}
+
+	if (USE_ALPHA_TEST && color.a < ALPHA_CUTOFF) {
+		discard;
+	}
+
+	outColor = vec4(color.rgb, 1.0);
 }
@@ -1,3 +1,25 @@
-C:/VulkanSDK/1.3.268.0/Bin/glslc.exe vertex/shader.vert -o vert.spv
-C:/VulkanSDK/1.3.268.0/Bin/glslc.exe fragment/shader.frag -o frag.spv
-pause
\ No newline at end of file
+@echo off
+rem Compiles the GLSL under shaders/glsl to SPIR-V:
+rem   - *.spv next to this script, loadable at runtime by path
+rem   - include/generated/*.inc word lists embedded into the binary by VEmbeddedShaders.h
+rem Runs as the VigorCMD pre-build step with "nopause", double click it to run by hand
+
+setlocal
+pushd "%~dp0"
+
+if defined VULKAN_SDK (set GLSLC="%VULKAN_SDK%\Bin\glslc.exe") else (set GLSLC="C:/VulkanSDK/1.3.268.0/Bin/glslc.exe")
+if not exist "..\..\include\generated" mkdir "..\..\include\generated"
+
+%GLSLC% vertex/shader.vert -o vert.spv || goto :failed
+%GLSLC% fragment/shader.frag -o frag.spv || goto :failed
+%GLSLC% -mfmt=num vertex/shader.vert -o ../../include/generated/shader.vert.inc || goto :failed
+%GLSLC% -mfmt=num fragment/shader.frag -o ../../include/generated/shader.frag.inc || goto :failed
+
+popd
+if not "%~1"=="nopause" pause
+exit /b 0
+
+:failed
+popd
+if not "%~1"=="nopause" pause
+exit /b 1
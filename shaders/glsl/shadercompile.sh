@@ -0,0 +1,15 @@
+#!/bin/sh
+# Compiles the GLSL under shaders/glsl to SPIR-V:
+#   - *.spv next to this script, loadable at runtime by path
+#   - include/generated/*.inc word lists embedded into the binary by VEmbeddedShaders.h
+set -e
+
+cd "$(dirname "$0")"
+
+GLSLC="${VULKAN_SDK:+$VULKAN_SDK/bin/}glslc"
+mkdir -p ../../include/generated
+
+"$GLSLC" vertex/shader.vert -o vert.spv
+"$GLSLC" fragment/shader.frag -o frag.spv
+"$GLSLC" -mfmt=num vertex/shader.vert -o ../../include/generated/shader.vert.inc
+"$GLSLC" -mfmt=num fragment/shader.frag -o ../../include/generated/shader.frag.inc
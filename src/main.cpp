@@ -1,9 +1,128 @@
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
 #include "../include/VEngine.h"
+#include "../include/VTextureBaker.h"
 
 int main(int argc, char* argv[])
 {
+    bool bRunDescriptorBenchmark = false;
+    Vigor::DescriptorBackendType descriptorBackendType = Vigor::DescriptorBackendType::Auto;
+    Vigor::LatencyProfile latencyProfile = Vigor::LatencyProfile::HighThroughput;
+    Vigor::PresentPolicy presentPolicy = Vigor::PresentPolicy::Mailbox;
+    double frameRateCap = 0.0; // uncapped
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view arg(argv[i]);
+
+        // offline step, no window or device: --bake-texture <source> [baked .vtex path] [--format=...] [--usage=...]
+        if (arg == "--bake-texture" && i + 1 < argc)
+        {
+            std::string sourcePath = argv[i + 1];
+            std::string bakedPath;
+            Vigor::TextureBaker::BakeOptions bakeOptions;
+
+            for (int j = i + 2; j < argc; j++)
+            {
+                std::string_view bakeArg(argv[j]);
+                if (bakeArg == "--format=rgba8")
+                {
+                    bakeOptions.encoding = Vigor::TextureBaker::TextureEncoding::RGBA8;
+                }
+                else if (bakeArg == "--format=bc1")
+                {
+                    bakeOptions.encoding = Vigor::TextureBaker::TextureEncoding::BC1;
+                }
+                else if (bakeArg == "--format=bc3")
+                {
+                    bakeOptions.encoding = Vigor::TextureBaker::TextureEncoding::BC3;
+                }
+                else if (bakeArg == "--format=bc5")
+                {
+                    bakeOptions.encoding = Vigor::TextureBaker::TextureEncoding::BC5;
+                }
+                else if (bakeArg == "--format=bc7")
+                {
+                    bakeOptions.encoding = Vigor::TextureBaker::TextureEncoding::BC7;
+                }
+                else if (bakeArg == "--usage=normal")
+                {
+                    bakeOptions.usage = Vigor::TextureBaker::TextureUsage::Normal;
+                }
+                else if (bakeArg == "--usage=data")
+                {
+                    bakeOptions.usage = Vigor::TextureBaker::TextureUsage::Data;
+                }
+                else if (!bakeArg.empty() && bakeArg[0] != '-')
+                {
+                    bakedPath = argv[j];
+                }
+            }
+
+            return Vigor::TextureBaker::Bake(sourcePath, bakedPath, bakeOptions) ? 0 : 1;
+        }
+
+        if (arg == "--bench-descriptors")
+        {
+            bRunDescriptorBenchmark = true;
+        }
+        else if (arg == "--descriptors=pooled")
+        {
+            descriptorBackendType = Vigor::DescriptorBackendType::Pooled;
+        }
+        else if (arg == "--descriptors=push")
+        {
+            descriptorBackendType = Vigor::DescriptorBackendType::Push;
+        }
+        else if (arg == "--descriptors=buffer")
+        {
+            descriptorBackendType = Vigor::DescriptorBackendType::DescriptorBuffer;
+        }
+        else if (arg == "--latency=low")
+        {
+            latencyProfile = Vigor::LatencyProfile::LowLatency;
+        }
+        else if (arg == "--latency=balanced")
+        {
+            latencyProfile = Vigor::LatencyProfile::Balanced;
+        }
+        else if (arg == "--latency=throughput")
+        {
+            latencyProfile = Vigor::LatencyProfile::HighThroughput;
+        }
+        else if (arg == "--present=fifo")
+        {
+            presentPolicy = Vigor::PresentPolicy::Fifo;
+        }
+        else if (arg == "--present=relaxed")
+        {
+            presentPolicy = Vigor::PresentPolicy::FifoRelaxed;
+        }
+        else if (arg == "--present=mailbox")
+        {
+            presentPolicy = Vigor::PresentPolicy::Mailbox;
+        }
+        else if (arg == "--present=immediate")
+        {
+            presentPolicy = Vigor::PresentPolicy::Immediate;
+        }
+        else if (arg.rfind("--fps-cap=", 0) == 0)
+        {
+            frameRateCap = std::strtod(argv[i] + strlen("--fps-cap="), nullptr); // 0 uncaps
+        }
+    }
+
     // TODO[CC] pass in window count via args/savedata
-    Vigor::VEngine VigorEngine{};
+    Vigor::VEngine VigorEngine{ 1, descriptorBackendType, latencyProfile, presentPolicy };
+    VigorEngine.SetFrameRateCap(frameRateCap);
+
+    if (bRunDescriptorBenchmark)
+    {
+        VigorEngine.RunDescriptorBenchmark();
+        return 0;
+    }
+
     VigorEngine.Run();
 
 	return 0;